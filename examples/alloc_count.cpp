@@ -0,0 +1,95 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "include/threadpool.hpp"
+
+// counts heap allocations per submitted task
+// usage: alloc_count [num_tasks] [workers]
+
+static std::atomic<std::size_t> total_allocs{0};
+static thread_local std::size_t thread_allocs = 0;
+
+// every replaced new/delete goes through these two, kept out of line so
+// the compiler doesn't pair inlined free() with operator new
+[[gnu::noinline]] static void* counted_alloc(std::size_t n, std::size_t al) {
+  total_allocs.fetch_add(1, std::memory_order::relaxed);
+  ++thread_allocs;
+  n = n ? n : 1;
+  auto p = al > alignof(std::max_align_t) ? std::aligned_alloc(al, (n + al - 1) & ~(al - 1)) : std::malloc(n);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+[[gnu::noinline]] static void counted_free(void* p) noexcept { std::free(p); }
+
+void* operator new(std::size_t n)                           { return counted_alloc(n, 0); }
+void* operator new[](std::size_t n)                         { return counted_alloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t al)      { return counted_alloc(n, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t n, std::align_val_t al)    { return counted_alloc(n, static_cast<std::size_t>(al)); }
+
+void operator delete(void* p) noexcept                                  { counted_free(p); }
+void operator delete[](void* p) noexcept                                { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept                     { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept                   { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept                { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept              { counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+
+using namespace std;
+
+static long work(long x) { return x * 2 + 1; }
+
+template <typename Submit>
+void measure(const char* name, size_t n, Submit&& submit) {
+  vector<future<long>> futs;
+  futs.reserve(n);
+
+  // warm up pools and buffers
+  for (size_t i = 0; i < n; ++i) futs.emplace_back(submit(i));
+  for (auto& f : futs) f.get();
+  futs.clear();
+
+  auto total0 = total_allocs.load();
+  auto mine0 = thread_allocs;
+  for (size_t i = 0; i < n; ++i) futs.emplace_back(submit(i));
+  auto mine = thread_allocs - mine0;
+  for (auto& f : futs) f.get();
+  auto total = total_allocs.load() - total0;
+  futs.clear();
+
+  cout << setw(28) << name
+       << setw(16) << fixed << setprecision(3) << double(mine)/n
+       << setw(16) << double(total)/n << endl;
+}
+
+int main(int argc, const char* const argv[]) {
+  const size_t n = argc > 1 ? stoull(argv[1]) : 100000;
+  const unsigned w = argc > 2 ? stoi(argv[2]) : 4;
+
+  cout << setw(28) << "path"
+       << setw(16) << "submit/task"
+       << setw(16) << "total/task" << endl;
+
+  for (bool direct : {false, true}) {
+    thp::threadpool tp(thp::pool_config{.max_threads = w, .direct_dispatch = direct});
+    auto suffix = direct ? " (direct)" : "";
+
+    measure((string("schedule(make_task)") + suffix).c_str(), n, [&](size_t i) {
+      auto [f] = tp.schedule(thp::make_task(work, static_cast<long>(i)));
+      return std::move(f);
+    });
+    measure((string("enqueue") + suffix).c_str(), n, [&](size_t i) {
+      auto [f] = tp.enqueue(work, static_cast<long>(i));
+      return std::move(f);
+    });
+    tp.shutdown();
+  }
+  return 0;
+}
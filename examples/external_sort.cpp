@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "include/external_sort.hpp"
+#include "include/clock_util.hpp"
+
+// usage: external_sort [times RAM = 2] [workers] [temp dir] [memory budget MB = 1024]
+//
+// writes a file of random 64 bit keys, RAM size times the first argument,
+// sorts it with thp::external_sorter and checks the result. Use a local
+// disk with room for three times the input (input, runs, output).
+
+namespace fs = std::filesystem;
+using key_type = std::uint64_t;
+
+std::size_t physical_memory() {
+  return static_cast<std::size_t>(::sysconf(_SC_PHYS_PAGES)) * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+void generate(const fs::path& p, std::size_t n) {
+  std::mt19937_64 e(std::random_device{}());
+  std::ofstream out(p, std::ios::binary);
+  std::vector<key_type> block(8u << 20);
+  for (std::size_t left = n; left > 0; ) {
+    const auto k = std::min(left, block.size());
+    for (std::size_t i = 0; i < k; ++i) block[i] = e();
+    out.write(reinterpret_cast<const char*>(block.data()), k * sizeof(key_type));
+    left -= k;
+  }
+}
+
+bool is_sorted(const fs::path& p) {
+  std::ifstream in(p, std::ios::binary);
+  std::vector<key_type> block(8u << 20);
+  key_type prev = 0;
+  while (in) {
+    in.read(reinterpret_cast<char*>(block.data()), block.size() * sizeof(key_type));
+    const auto k = static_cast<std::size_t>(in.gcount()) / sizeof(key_type);
+    for (std::size_t i = 0; i < k; ++i) {
+      if (block[i] < prev) return false;
+      prev = block[i];
+    }
+  }
+  return true;
+}
+
+int main(int argc, const char* const argv[]) {
+  const double times = argc > 1 ? std::stod(argv[1]) : 2.0;
+  const unsigned workers = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+  const fs::path dir = argc > 3 ? fs::path(argv[3]) : fs::temp_directory_path();
+  const std::size_t budget = (argc > 4 ? std::stoull(argv[4]) : 1024) << 20;
+
+  const auto bytes = static_cast<std::size_t>(times * physical_memory());
+  const auto n = bytes / sizeof(key_type);
+  const auto in = dir / "thp_ext_in", out = dir / "thp_ext_out";
+  thp::util::clock_util<std::chrono::steady_clock> cp;
+
+  try {
+    std::cerr << "generating " << (n * sizeof(key_type) >> 20) << " MB in " << dir << std::endl;
+    cp.now();
+    generate(in, n);
+    cp.now();
+    std::cerr << "generate (s): " << cp.get_ms() / 1000 << std::endl;
+
+    thp::threadpool tp(workers);
+    thp::external_sorter<key_type> sorter(tp, {.temp_dir = dir, .memory_budget = budget});
+    cp.now();
+    auto stats = sorter.sort(in, out);
+    cp.now();
+    const auto secs = cp.get_ms() / 1000;
+
+    std::cerr << std::setw(14) << "records"
+              << std::setw(14) << "runs"
+              << std::setw(14) << "time (s)"
+              << std::setw(14) << "MB/s"
+              << std::setw(14) << "is_sorted" << std::endl;
+    std::cerr << std::setw(14) << stats.records
+              << std::setw(14) << stats.runs
+              << std::setw(14) << secs
+              << std::setw(14) << (stats.records * sizeof(key_type) >> 20) / secs
+              << std::setw(14) << is_sorted(out) << std::endl;
+    tp.shutdown();
+  } catch (std::exception& ex) {
+    std::cerr << "main: Exception: " << ex.what() << std::endl;
+  }
+
+  fs::remove(in);
+  fs::remove(out);
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <random>
+#include <execution>
+#include <numeric>
+#include <locale>
+
+#include "include/threadpool.hpp"
+#include "include/partitioner.hpp"
+#include "include/clock_util.hpp"
+
+// usage: scan [size = 10 million] [workers] [stl]
+
+int main(int argc, const char* const argv[])
+{
+  const unsigned n = argc > 1 ? std::stoi(argv[1]) : 10*1000000; // 10 million
+  const unsigned workers = argc > 2 ? std::stoi(argv[2]) : std::thread::hardware_concurrency();
+  bool use_stl = argc > 3;
+
+  std::locale::global(std::locale(""));
+  auto old = std::cout.imbue(std::locale(""));
+
+  thp::util::clock_util<std::chrono::steady_clock> cu;
+  try {
+    std::mt19937_64 engine(std::random_device{}());
+    std::uniform_int_distribution<long> dis(-1000, 1000);
+    std::vector<long> data, expect(n), out(n);
+    data.reserve(n);
+    std::generate_n(std::back_inserter(data), n, [&] { return dis(engine); });
+    cu.now();
+    std::cout << "data generation (" << data.size() << "): " << cu.get_ms() << " ms\n";
+
+    cu.now();
+    std::inclusive_scan(data.cbegin(), data.cend(), expect.begin());
+    cu.now();
+    std::cout << "std::inclusive_scan(" << data.size() << "): " << cu.get_ms() << " ms" << std::endl;
+
+    if (use_stl) {
+      cu.now();
+      std::inclusive_scan(std::execution::par, data.cbegin(), data.cend(), out.begin());
+      cu.now();
+      std::cout << "std::inclusive_scan(par, " << data.size() << "): " << cu.get_ms() << " ms" << std::endl;
+    }
+
+    {
+      thp::threadpool tp(workers);
+      const std::size_t num_partitions = std::clamp<std::size_t>(data.size()/100000u, 1, 4*workers);
+      cu.now();
+      auto [f] = tp.inclusive_scan(data.cbegin(), data.cend(), out.begin(), std::plus<>{},
+                                   thp::partition::EqualSize(data.cbegin(), data.cend(), num_partitions));
+      f.get();
+      cu.now();
+      std::cout << "thp::inclusive_scan(" << data.size() << "): " << cu.get_ms() << " ms"
+                << ", matches = " << (out == expect) << std::endl;
+      tp.shutdown();
+    }
+  } catch(std::exception& ex) {
+    std::cerr << "main: Exception: " << ex.what() << std::endl;
+  }
+  std::cout.imbue(old);
+  return 0;
+}
@@ -38,42 +38,48 @@ int main(int argc, const char* const argv[]) {
   try {
     std::random_device r;
     std::mt19937_64 e(r());
-    //std::uniform_int_distribution<int> dis(numeric_limits<int>::min()+1, numeric_limits<int>::max()-1);
-    std::uniform_int_distribution<char> dis('a', 'z');
+    std::uniform_int_distribution<int> dis(numeric_limits<int>::min(), numeric_limits<int>::max());
 
     using value_type = typename decltype(dis)::result_type;
 
     thp::threadpool tp(workers);
     std::cerr << std::setw(14) << "size"
               << std::setw(14) << "time (ms)"
-              << std::setw(14) << "is_sorted"
-              << std::setw(14) << "stl(ms)" << std::endl;
-    for(decltype(N) n = 10; n <= N; n *= 10) {
-      std::vector<value_type> data;
-      data.reserve(n);
+              << std::setw(14) << "is_sorted";
+    if (use_stl)
+      std::cerr << std::setw(14) << "stl par(ms)"
+                << std::setw(14) << "speedup";
+    std::cerr << std::endl;
 
-      std::generate_n(std::back_inserter(data), n, [&] { return dis(e); });
+    std::vector<value_type> input, data;
+    for(decltype(N) n = 10; n <= N; n *= 10) {
+      input.clear();
+      std::generate_n(std::back_inserter(input), n, [&] { return dis(e); });
 
+      data = input;
       cp.now();
       auto [fut] = tp.sort(data.begin(), data.end());
       fut.wait();
       cp.now();
+      const auto thp_ms = cp.get_ms();
 
       std::cerr << std::right << std::setw(14) << data.size()
-                << std::setw(14) << cp.get_ms()
+                << std::setw(14) << thp_ms
                 << std::setw(14) << std::ranges::is_sorted(data);
 
       if (use_stl) {
-        std::shuffle(data.begin(), data.end(), e);
+        data = input;
         cp.now();
         std::sort(std::execution::par, data.begin(), data.end());
         cp.now();
+        const auto stl_ms = cp.get_ms();
 
-        std::cerr << std::setw(14) << cp.get_ms();
+        std::cerr << std::setw(14) << stl_ms
+                  << std::setw(14) << std::fixed << std::setprecision(2) << stl_ms / std::max(thp_ms, 1e-3)
+                  << std::defaultfloat << std::setprecision(6);
       }
 
       std::cerr << std::endl;
-      //std::ranges::copy(data, std::ostream_iterator<std::decay_t<decltype(data.at(0))>>(std::cerr, ""));
     }
   } catch (exception &ex) {
     cerr << "main: Exception: " << ex.what() << endl;
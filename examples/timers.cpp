@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "include/timer_service.hpp"
+#include "include/worker_pool.hpp"
+#include "include/clock_util.hpp"
+
+// cost of many pending timers in timer_service (hierarchical timing wheel)
+// usage: timers [num_timers] [spread_ms]
+//
+// schedules num_timers timers due uniformly over spread_ms starting 500ms
+// out, cancels every 10th, then reports firing lateness (jitter) of the rest
+
+using namespace std;
+using clk = chrono::steady_clock;
+
+static double rss_mb() {
+  ifstream f("/proc/self/statm");
+  size_t pages = 0, resident = 0;
+  f >> pages >> resident;
+  return resident * double(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+int main(int argc, const char* const argv[]) {
+  const size_t n = argc > 1 ? stoull(argv[1]) : 1000000;
+  const auto spread = chrono::milliseconds(argc > 2 ? stoi(argv[2]) : 2000);
+
+  thp::timer_service ts;
+  thp::worker_pool thread;
+  thread.start_thread(&thp::timer_service::run, &ts);
+
+  vector<clk::time_point> due(n);
+  vector<float> late_us(n, -1.0f);
+  vector<thp::timer_id> ids(n);
+  atomic<size_t> fired{0};
+
+  mt19937_64 rng(1);
+  const auto start = clk::now() + chrono::milliseconds(500);
+  for (auto& d : due) d = start + chrono::nanoseconds(rng() % chrono::nanoseconds(spread).count());
+
+  const auto rss0 = rss_mb();
+  thp::util::clock_util<clk> cu;
+  cu.now();
+  for (size_t i = 0; i < n; ++i) {
+    ids[i] = ts.schedule_at(due[i], [&, i] {
+      late_us[i] = chrono::duration<float, micro>(clk::now() - due[i]).count();
+      fired.fetch_add(1, memory_order::relaxed);
+    });
+  }
+  cu.now();
+  const auto schedule_ns = cu.get_us() * 1000 / n;
+  const auto rss1 = rss_mb();
+
+  size_t cancelled = 0;
+  cu.now();
+  for (size_t i = 0; i < n; i += 10) cancelled += ts.cancel(ids[i]);
+  cu.now();
+  const auto cancel_ns = cu.get_us() * 1000 / max<size_t>(1, cancelled);
+
+  while (fired.load() + cancelled < n) this_thread::sleep_for(chrono::milliseconds(10));
+  thread.shutdown();
+
+  vector<float> late;
+  late.reserve(n);
+  for (auto l : late_us) if (l >= 0) late.push_back(l);
+  sort(late.begin(), late.end());
+  auto pct = [&](double p) { return late[static_cast<size_t>(p * (late.size() - 1))]; };
+
+  cout << fixed << setprecision(1)
+       << "timers:           " << n << " (" << cancelled << " cancelled)\n"
+       << "schedule:         " << schedule_ns << " ns/timer\n"
+       << "cancel:           " << cancel_ns << " ns/timer\n"
+       << "memory:           " << rss1 - rss0 << " MB (" << (rss1 - rss0) * (1 << 20) / n << " B/timer)\n"
+       << "lateness p50:     " << pct(0.5) << " us\n"
+       << "lateness p99:     " << pct(0.99) << " us\n"
+       << "lateness max:     " << late.back() << " us\n"
+       << "early firings:    " << count_if(late_us.begin(), late_us.end(), [](float l) { return l < 0 && l != -1.0f; }) << endl;
+  return 0;
+}
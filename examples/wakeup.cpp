@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/threadpool.hpp"
+
+// wake up latency and cpu cost of idle workers for each wait strategy
+// usage: wakeup [rounds] [workers] [idle_gap_us]
+//
+// every round pool is left idle for idle_gap_us, then one task (single) or
+// one task per worker (burst) is posted. Latency is post -> task start.
+// cpu/wall is process cpu time over wall time, ~ number of busy cores.
+
+using namespace std;
+using clk = chrono::steady_clock;
+
+static double cpu_sec() {
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+struct result {
+  double p50, p99, burst, cpu;
+};
+
+static double percentile(vector<double>& v, double p) {
+  auto k = static_cast<size_t>(p * (v.size() - 1));
+  nth_element(v.begin(), v.begin() + k, v.end());
+  return v[k];
+}
+
+result measure(thp::pool_config cfg, unsigned rounds, chrono::microseconds gap) {
+  thp::threadpool tp(cfg);
+  vector<double> lat, burst;
+  lat.reserve(rounds);
+  burst.reserve(rounds);
+
+  const auto wall0 = clk::now();
+  const auto cpu0 = cpu_sec();
+  for (unsigned r = 0; r < rounds; ++r) {
+    // single task
+    this_thread::sleep_for(gap);
+    std::atomic<unsigned> done{0};
+    clk::time_point started;
+    auto t0 = clk::now();
+    tp.post([&] {
+      started = clk::now();
+      done.store(1);
+      done.notify_one();
+    });
+    done.wait(0);
+    lat.push_back(chrono::duration<double, micro>(started - t0).count());
+
+    // one task per worker, time till last one starts
+    this_thread::sleep_for(gap);
+    std::atomic<unsigned> left{cfg.max_threads};
+    std::atomic<clk::rep> last{0};
+    t0 = clk::now();
+    for (unsigned i = 0; i < cfg.max_threads; ++i) {
+      tp.post([&] {
+        auto now = clk::now().time_since_epoch().count();
+        auto prev = last.load();
+        while (prev < now && !last.compare_exchange_weak(prev, now));
+        if (left.fetch_sub(1) == 1) left.notify_one();
+      });
+    }
+    for (auto v = left.load(); v != 0; v = left.load()) left.wait(v);
+    burst.push_back(chrono::duration<double, micro>(clk::duration(last.load()) - t0.time_since_epoch()).count());
+  }
+  const auto cpu = (cpu_sec() - cpu0) / chrono::duration<double>(clk::now() - wall0).count();
+  tp.shutdown();
+  return {percentile(lat, 0.5), percentile(lat, 0.99), percentile(burst, 0.5), cpu};
+}
+
+int main(int argc, const char* const argv[]) {
+  const unsigned rounds = argc > 1 ? stoi(argv[1]) : 500;
+  const unsigned w = argc > 2 ? stoi(argv[2]) : max(1u, min(4u, thread::hardware_concurrency()));
+  const chrono::microseconds gap(argc > 3 ? stoi(argv[3]) : 200);
+
+  const pair<const char*, thp::wait_strategy> strategies[] = {
+    {"condvar",    thp::wait_strategy::eCondVar},
+    {"park",       thp::wait_strategy::ePark},
+    {"spin+park",  thp::wait_strategy::eSpinPark},
+    {"busy poll",  thp::wait_strategy::eBusyPoll},
+  };
+
+  cout << setw(12) << "dispatch"
+       << setw(12) << "wait"
+       << setw(12) << "p50 us"
+       << setw(12) << "p99 us"
+       << setw(14) << "burst p50 us"
+       << setw(10) << "cpu/wall" << endl;
+
+  for (auto mode : {thp::dispatch_mode::eShared, thp::dispatch_mode::eWorkStealing}) {
+    for (auto [name, wait] : strategies) {
+      auto r = measure(thp::pool_config{.max_threads = w, .dispatch = mode, .wait = wait}, rounds, gap);
+      cout << setw(12) << (mode == thp::dispatch_mode::eShared ? "shared" : "stealing")
+           << setw(12) << name
+           << fixed << setprecision(1)
+           << setw(12) << r.p50
+           << setw(12) << r.p99
+           << setw(14) << r.burst
+           << setprecision(2)
+           << setw(10) << r.cpu << endl;
+    }
+  }
+  return 0;
+}
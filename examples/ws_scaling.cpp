@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <locale>
+
+#include "include/threadpool.hpp"
+#include "include/clock_util.hpp"
+
+// tasks/sec vs worker count for shared output deque and work stealing dispatch
+// usage: ws_scaling [num_tasks] [max_workers]
+
+using namespace std;
+
+static int tiny_work(int x) {
+  int s = 0;
+  for (int i = 0; i < 64; ++i) s += (x ^ i) & 7;
+  return s;
+}
+
+// all tasks submitted from main thread
+double external_submit(thp::threadpool& tp, size_t n) {
+  thp::util::clock_util<chrono::steady_clock> cu;
+  vector<future<int>> futs;
+  futs.reserve(n);
+  cu.now();
+  for (size_t i = 0; i < n; ++i) {
+    auto [f] = tp.enqueue(tiny_work, static_cast<int>(i));
+    futs.emplace_back(std::move(f));
+  }
+  for (auto& f : futs) f.wait();
+  cu.now();
+  return n / cu.get_sec();
+}
+
+// few root tasks, each spawns its share of children from inside the pool
+double spawned_submit(thp::threadpool& tp, size_t n, unsigned roots) {
+  thp::util::clock_util<chrono::steady_clock> cu;
+  const size_t per_root = n / roots;
+  vector<future<vector<future<int>>>> root_futs;
+  cu.now();
+  for (unsigned r = 0; r < roots; ++r) {
+    auto [f] = tp.enqueue([&tp, per_root] {
+      vector<future<int>> children;
+      children.reserve(per_root);
+      for (size_t i = 0; i < per_root; ++i) {
+        auto [c] = tp.enqueue(tiny_work, static_cast<int>(i));
+        children.emplace_back(std::move(c));
+      }
+      return children;
+    });
+    root_futs.emplace_back(std::move(f));
+  }
+  for (auto& rf : root_futs)
+    for (auto& c : rf.get()) c.wait();
+  cu.now();
+  return per_root * roots / cu.get_sec();
+}
+
+int main(int argc, const char* const argv[]) {
+  const size_t n = argc > 1 ? stoull(argv[1]) : 200000;
+  const unsigned max_workers = argc > 2 ? stoi(argv[2]) : thread::hardware_concurrency();
+
+  std::locale::global(std::locale(""));
+  std::cout.imbue(std::locale(""));
+
+  cout << setw(8) << "workers"
+       << setw(18) << "shared ext/s"
+       << setw(18) << "ws ext/s"
+       << setw(18) << "decentral ext/s"
+       << setw(18) << "shared spawn/s"
+       << setw(18) << "ws spawn/s"
+       << setw(18) << "decentral spawn/s" << endl;
+
+  for (unsigned w = 1; w <= max_workers; w *= 2) {
+    double res[6];
+    int k = 0;
+    for (auto mode : {thp::dispatch_mode::eShared, thp::dispatch_mode::eWorkStealing, thp::dispatch_mode::eDecentralized}) {
+      thp::threadpool tp(thp::pool_config{.max_threads = w, .dispatch = mode});
+      res[k] = external_submit(tp, n);
+      res[k+3] = spawned_submit(tp, n, w);
+      ++k;
+      tp.shutdown();
+    }
+    cout << setw(8) << w << fixed << setprecision(0);
+    for (auto r : res) cout << setw(18) << r;
+    cout << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,142 @@
+#ifndef AUTO_SELECT_HPP_
+#define AUTO_SELECT_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "include/algos/scheduling/schedule_algos.hpp"
+#include "include/configuration.hpp"
+#include "include/statistics.hpp"
+
+namespace thp {
+namespace sched_algos {
+
+//
+// picks among candidate algorithms by trying them on live traffic
+//
+// Explore phase runs each candidate for Static::auto_trial_period() and
+// scores it as throughput / (1 + p99 wait / Static::batch_target()), where
+// throughput is tasks dispatched per second and p99 is over the per tick
+// wait samples of the trial. Best candidate then runs for
+// Static::auto_exploit_period() before the next exploration, so a shift in
+// workload is picked up. Score is the mean over all scored trials, a trial
+// which dispatched nothing leaves its score as is. Workers scheduling
+// themselves (apply(stats, tid)) use the candidate in use, they take no
+// part in exploration.
+//
+class auto_algo : public schedule_algo {
+  using clock = std::chrono::system_clock;
+
+  struct candidate {
+    names name;
+    std::shared_ptr<schedule_algo> algo;
+    double score;     // < 0 until first scored trial
+    unsigned trials;  // scored trials, score is their mean
+  };
+
+public:
+  explicit auto_algo(std::vector<std::pair<names, std::shared_ptr<schedule_algo>>> algos)
+  : cands{}
+  , cur{0}
+  , active{0}
+  , exploring{true}
+  , started{false}
+  , start{}
+  , dispatched{0}
+  , waits{}
+  , chosen{eInvalid}
+  {
+    for (auto& [n, a] : algos) cands.push_back({n, std::move(a), -1.0, 0u});
+    if (!cands.empty()) chosen.store(cands[0].name);
+  }
+
+  void install(const std::vector<task_queue*>& qs) override {
+    for (auto& c : cands) c.algo->install(qs);
+  }
+
+  void apply(statistics& stats) override {
+    if (cands.empty()) return;
+    if (!started) {
+      started = true;
+      begin(stats.ts, 0);
+    }
+
+    cands[cur].algo->apply(stats);
+    dispatched += stats.jobq.out.new_tasks;
+    if (stats.sched.wait_sample.count() > 0) waits.push_back(stats.sched.wait_sample);
+
+    const auto elapsed = stats.ts - start;
+    if (exploring) {
+      if (elapsed < Static::auto_trial_period()) return;
+      score(cands[cur], elapsed);
+      if (cur + 1 < cands.size()) return begin(stats.ts, cur + 1);
+      exploring = false;
+      begin(stats.ts, best());
+    }
+    else if (elapsed >= Static::auto_exploit_period()) {
+      exploring = true;
+      begin(stats.ts, 0);
+    }
+  }
+
+  int apply(statistics& stats, std::thread::id tid) override {
+    return cands.empty() ? 0 : cands[active.load(std::memory_order::relaxed)].algo->apply(stats, tid);
+  }
+
+  // candidate in use, any thread
+  names current() const { return chosen.load(std::memory_order::relaxed); }
+
+  bool converged() const { return started && !exploring; }
+
+private:
+  void begin(clock::time_point now, std::size_t i) {
+    cur = i;
+    active.store(i, std::memory_order::relaxed);
+    start = now;
+    dispatched = 0;
+    waits.clear();
+    chosen.store(cands[i].name, std::memory_order::relaxed);
+  }
+
+  void score(candidate& c, clock::duration elapsed) {
+    if (0u == dispatched) return;
+    const auto secs = std::chrono::duration<double>(elapsed).count();
+    double p99 = 0;
+    if (!waits.empty()) {
+      auto k = waits.begin() + (waits.size() * 99) / 100;
+      std::nth_element(waits.begin(), k, waits.end());
+      p99 = static_cast<double>(k->count());
+    }
+    const auto target = static_cast<double>(std::chrono::nanoseconds(Static::batch_target()).count());
+    const auto s = (dispatched / secs) / (1.0 + p99 / target);
+    ++c.trials;
+    c.score = c.trials == 1 ? s : c.score + (s - c.score) / c.trials;
+  }
+
+  std::size_t best() const {
+    std::size_t b = cur;
+    for (std::size_t i = 0; i < cands.size(); ++i)
+      if (cands[i].score > cands[b].score) b = i;
+    return b;
+  }
+
+  std::vector<candidate> cands;
+  std::size_t cur;
+  std::atomic<std::size_t> active;
+  bool exploring;
+  bool started;
+  clock::time_point start;
+  std::size_t dispatched;
+  std::vector<std::chrono::nanoseconds> waits;
+  std::atomic<names> chosen;
+};
+
+} // namespace sched_algos
+} // namespace thp
+
+#endif // AUTO_SELECT_HPP_
@@ -0,0 +1,80 @@
+#ifndef EDF_HPP_
+#define EDF_HPP_
+
+#include <thread>
+#include <vector>
+
+#include "include/algos/scheduling/schedule_algos.hpp"
+#include "include/deadline_taskq.hpp"
+#include "include/statistics.hpp"
+
+namespace thp {
+namespace sched_algos {
+
+//
+// earliest deadline first
+//
+// Tick budget goes to deadline tasks which can still make it, earliest
+// deadline first, then to the other queues in input order, and last to
+// tasks demoted for missing their deadline (see deadline_policy). Budget is
+// as in fairshare_algo: load_factor * num_workers, or everything queued
+// when load_factor < 0. Queues are the ones given to install().
+//
+class edf_algo : public schedule_algo {
+public:
+  // splits queues once, ticks don't look at queue types
+  void install(const std::vector<task_queue*>& qs) override {
+    deadline_qs.clear();
+    other_qs.clear();
+    for (auto q : qs) {
+      if (auto d = dynamic_cast<deadline_taskq*>(q)) deadline_qs.push_back(d);
+      else other_qs.push_back(q);
+    }
+  }
+
+  void apply(statistics& stats) override {
+    auto& output = *stats.jobq.out.cur_output;
+    const auto n = output.size();
+
+    std::size_t budget = 0;
+    if (stats.jobq.in.load_factor < 0)
+      for (auto q : stats.jobq.in.qs) budget += q->len();
+    else
+      budget = stats.jobq.in.load_factor * stats.pool.num_workers;
+
+    for (auto d : deadline_qs) budget -= d->pop_on_time(output, budget);
+    for (auto q : other_qs) {
+      if (budget == 0) break;
+      budget -= q->pop_n(output, budget);
+    }
+    for (auto d : deadline_qs) budget -= d->pop_late(output, budget);
+
+    stats.jobq.out.new_tasks = output.size() - n;
+  }
+
+  // same order for one worker's batch, queue split is only read
+  int apply(statistics& stats, std::thread::id) override {
+    auto& output = *stats.jobq.out.cur_output;
+    const auto n = worker_budget(stats);
+    std::size_t got = 0;
+    for (auto d : deadline_qs)
+      if (got < n) got += d->pop_on_time(output, n - got);
+    for (auto q : other_qs) {
+      if (got >= n) break;
+      got += q->pop_n(output, n - got);
+    }
+    for (auto d : deadline_qs)
+      if (got < n) got += d->pop_late(output, n - got);
+    stats.jobq.out.new_tasks = got;
+    return static_cast<int>(got);
+  }
+
+private:
+  std::vector<deadline_taskq*> deadline_qs;
+  std::vector<task_queue*> other_qs;
+};
+
+} // namespace sched_algos
+} // namespace thp
+
+#endif // EDF_HPP_
@@ -3,6 +3,8 @@
 
 #include <thread>
 #include <vector>
+#include <algorithm>
+#include <functional>
 #include <random>
 #include <ranges>
 
@@ -12,38 +14,114 @@
 namespace thp {
 namespace sched_algos {
 
+//
+// weighted deficit round robin across task queues
+//
+// every visit a non empty queue earns its weight in credits, one credit buys
+// one task into output. Queue which runs dry loses its credits, so idle
+// classes can't bank service. Over any window each busy queue gets
+// weight/sum(weights) of output, off by at most one quantum.
+// Tick budget is load_factor * num_workers tasks, or whatever is queued at
+// start of tick when load_factor < 0. Round robin position carries over
+// ticks, so a small budget doesn't always favour first queue.
+//
 class fairshare_algo : public schedule_algo {
-private:
-  std::random_device rd;
-
 public:
-  explicit fairshare_algo() : rd{} {}
+  explicit fairshare_algo()
+  : deficit{}
+  , cursor{0}
+  , granted{false}
+  {}
 
   void apply(statistics& stats) override {
     const auto& inputs = stats.jobq.in.qs;
     auto& output = *stats.jobq.out.cur_output; // TODO(find out why auto& works and auto doesn't)
-    auto n = output.size();
-    auto expected_items = stats.jobq.in.load_factor * stats.pool.num_workers;
-
-    if (stats.jobq.in.load_factor < 0) {
-      // put all tasks in queue
-      std::ranges::for_each(inputs, [&](auto&& q) {
-        q->pop_n(output, q->len());
-      });
+    const auto nq = inputs.size();
+    const auto n = output.size();
+    if (nq == 0) return;
+    if (deficit.size() != nq) {
+      deficit.assign(nq, 0);
+      cursor = 0;
+      granted = false;
     }
-    else if (output.size() < expected_items) {
-      std::ranges::for_each(inputs, [&](auto&& q) {
-                   std::unique_ptr<executable> t;
-                   if (q->pop(t))
-                     output.emplace_back(std::move(t));
-               });
+
+    std::size_t budget = 0;
+    if (stats.jobq.in.load_factor < 0)
+      for (auto q : inputs) budget += q->len();
+    else
+      budget = stats.jobq.in.load_factor * stats.pool.num_workers;
+
+    // stop after one full pass without any task
+    for (std::size_t idle_visits = 0; budget > 0 && idle_visits < nq; ) {
+      auto q = inputs[cursor];
+      auto len = q->len();
+      std::size_t got = 0;
+      if (len > 0) {
+        if (!granted) {
+          deficit[cursor] += weight(stats, cursor);
+          granted = true;
+        }
+        got = q->pop_n(output, std::min({deficit[cursor], budget, len}));
+        deficit[cursor] -= got;
+        budget -= got;
+      }
+
+      if (got == 0) {
+        ++idle_visits;
+        deficit[cursor] = 0;
+      }
+      else {
+        idle_visits = 0;
+        if (q->empty()) deficit[cursor] = 0;
+        else if (deficit[cursor] > 0) continue; // out of budget, resume here next tick
+      }
+      granted = false;
+      cursor = (cursor + 1) % nq;
     }
     stats.jobq.out.new_tasks = output.size() - n;
   }
 
+  // stateless per worker variant: picks a non empty queue with probability
+  // weight/sum(weights), so over many workers and batches shares match DRR
   int apply(statistics& stats, std::thread::id tid) override {
+    thread_local std::minstd_rand rng{static_cast<unsigned>(std::hash<std::thread::id>{}(tid))};
+    const auto& inputs = stats.jobq.in.qs;
+    auto& output = *stats.jobq.out.cur_output;
+    const auto nq = inputs.size();
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < nq; ++i)
+      if (!inputs[i]->empty()) total += weight(stats, i);
+    if (total == 0) return 0;
+
+    auto r = rng() % total;
+    std::size_t i = 0;
+    for (; i < nq; ++i) {
+      if (inputs[i]->empty()) continue;
+      const auto w = weight(stats, i);
+      if (r < w) break;
+      r -= w;
+    }
+    // queue may have been drained meanwhile, then take from the next one
+    for (std::size_t k = 0; k < nq; ++k) {
+      auto q = inputs[(i + k) % nq];
+      if (auto got = q->pop_n(output, worker_budget(stats))) {
+        stats.jobq.out.new_tasks = got;
+        return static_cast<int>(got);
+      }
+    }
     return 0;
   }
+
+private:
+  static std::size_t weight(const statistics& stats, std::size_t i) {
+    const auto& w = stats.jobq.in.weights;
+    return i < w.size() ? std::max(1u, w[i]) : 1u;
+  }
+
+  std::vector<std::size_t> deficit;
+  std::size_t cursor;
+  bool granted;
 };
 
 } // namespace sched_algos
@@ -23,6 +23,14 @@ struct first_avail_algo : schedule_algo {
   }
 
   int apply(statistics& stats, std::thread::id tid) override {
+    auto& output = *stats.jobq.out.cur_output;
+    const auto n = worker_budget(stats);
+    for (auto q : stats.jobq.in.qs) {
+      if (auto k = q->pop_n(output, n)) {
+        stats.jobq.out.new_tasks = k;
+        return static_cast<int>(k);
+      }
+    }
     return 0;
   }
 protected:
@@ -1,6 +1,7 @@
 #ifndef MAXLEN_HPP_
 #define MAXLEN_HPP_
 
+#include <algorithm>
 #include <thread>
 #include <memory>
 #include <vector>
@@ -25,7 +26,11 @@ struct maxlen_algo : schedule_algo {
 
   int apply(statistics& stats, std::thread::id tid)
   {
-    return 0;
+    const auto& inputs = stats.jobq.in.qs;
+    if (inputs.empty()) return 0;
+    auto maxq = *std::ranges::max_element(inputs, {}, &task_queue::len);
+    stats.jobq.out.new_tasks = maxq->pop_n(*stats.jobq.out.cur_output, worker_budget(stats));
+    return static_cast<int>(stats.jobq.out.new_tasks);
   }
 
 };
@@ -3,6 +3,7 @@
 
 #include <thread>
 #include <limits>
+#include <vector>
 
 #include "include/statistics.hpp"
 
@@ -14,17 +15,34 @@ enum names : uint8_t
   eFirstAvailable = 0,
   eMaxLen = 1,
   eFairShare = 2,
+  eEdf = 3,
+  eAuto = 4,   // picks one of the above from live statistics
 
   eInvalid = std::numeric_limits<uint8_t>::max()
 };
 
 // algo interface
+//
+// apply(stats) runs on scheduler thread and fills stats.jobq.out for all
+// workers. apply(stats, tid) runs on worker tid when its local work is gone
+// (dispatch_mode::eDecentralized), concurrently with other workers, so it
+// must not touch algorithm state. It takes a batch of worker_budget(stats)
+// tasks into the worker's own output and returns the count.
+// install(qs) is called once with the job queue's input queues, before
+// any apply, algorithms may keep what they derive from them.
 struct schedule_algo {
+  virtual void install(const std::vector<task_queue*>&) {}
   virtual bool ok(statistics&) { return false; }
   virtual void apply(statistics& ) = 0;
   virtual int apply(statistics&, std::thread::id ) = 0;
+  virtual ~schedule_algo() = default;
 };
 
+// tasks one worker takes per apply(stats, tid)
+inline std::size_t worker_budget(const statistics& stats) {
+  return stats.jobq.in.load_factor > 0 ? static_cast<std::size_t>(stats.jobq.in.load_factor) : 1u;
+}
+
 } // namespace sched_algos
 } // namespace thp
 
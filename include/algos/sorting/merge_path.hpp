@@ -0,0 +1,81 @@
+#ifndef MERGE_PATH_HPP_
+#define MERGE_PATH_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+
+namespace thp {
+namespace sorting {
+
+//
+// merge path (co-rank) partitioning. Output of merging sorted a and b is
+// cut at any position d without merging first: co_rank(d) is the number
+// of elements of a among the first d merged ones, found by binary search.
+// So one merge splits into pieces merged independently, each writing its
+// own part of the output.
+//
+
+// elements of a in the first d outputs of stable merge(a, b), ties go to a
+template <std::random_access_iterator A, std::random_access_iterator B,
+          typename Comp, typename Proj>
+std::size_t co_rank(std::size_t d, A a, std::size_t na, B b, std::size_t nb,
+                    Comp& comp, Proj& proj) {
+  auto lo = d > nb ? d - nb : 0;
+  auto hi = std::min(d, na);
+  while (lo < hi) {
+    const auto i = lo + (hi - lo) / 2;
+    // a[i] doesn't go after b[d-i-1], so it's among first d as well
+    if (!std::invoke(comp, std::invoke(proj, b[d - i - 1]), std::invoke(proj, a[i]))) lo = i + 1;
+    else hi = i;
+  }
+  return lo;
+}
+
+//
+// one level of bottom up mergesort: src holds sorted runs of width w
+// (last one may be shorter), pairs of them are merged into dst.
+// level_rank(d) is co_rank of output position d within its pair.
+//
+template <std::random_access_iterator I, typename Comp, typename Proj>
+std::size_t level_rank(I src, std::size_t n, std::size_t w, std::size_t d,
+                       Comp& comp, Proj& proj) {
+  const auto p = d - d % (2 * w);
+  if (p >= n) return 0;
+  const auto na = std::min(w, n - p);
+  const auto nb = std::min(w, n - p - na);
+  return co_rank(d - p, src + p, na, src + p + na, nb, comp, proj);
+}
+
+// writes dst[d0, d1) only, r0 and r1 are level_rank of d0 and d1. Ranks
+// of all pieces are taken before any of them runs, since elements are
+// moved out of src.
+template <std::random_access_iterator I, std::random_access_iterator O,
+          typename Comp, typename Proj>
+void merge_level(I src, O dst, std::size_t n, std::size_t w,
+                 std::size_t d0, std::size_t d1, std::size_t r0, std::size_t r1,
+                 Comp comp, Proj proj) {
+  while (d0 < d1) {
+    const auto p = d0 - d0 % (2 * w);
+    const auto na = std::min(w, n - p);
+    const auto nb = std::min(w, n - p - na);
+    const auto e = std::min(d1, p + na + nb);
+    const auto i1 = e == d1 && e < p + na + nb ? r1 : na;
+
+    auto a = src + p;
+    auto b = a + na;
+    const auto j0 = d0 - p - r0;
+    const auto j1 = e - p - i1;
+    std::ranges::merge(std::make_move_iterator(a + r0), std::make_move_iterator(a + i1),
+                       std::make_move_iterator(b + j0), std::make_move_iterator(b + j1),
+                       dst + d0, std::ref(comp), std::ref(proj), std::ref(proj));
+    d0 = e;
+    r0 = 0;
+  }
+}
+
+} // namespace sorting
+} // namespace thp
+
+#endif // MERGE_PATH_HPP_
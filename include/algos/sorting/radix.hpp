@@ -0,0 +1,126 @@
+#ifndef RADIX_HPP_
+#define RADIX_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace thp {
+namespace sorting {
+
+//
+// building blocks of LSD radix sort, one byte of the key per pass. Keys
+// are arithmetic values proj(x), mapped to unsigned integers of the same
+// width which compare the same way (radix_bits). Each pass histograms
+// the digit per chunk, turns chunk histograms into scatter offsets and
+// scatters chunks to the other buffer, which keeps it stable.
+//
+
+// up to 64 bit integers and IEEE floats, others (long double) aren't mapped
+template <typename K>
+concept radix_key = std::is_arithmetic_v<K> && !std::same_as<K, bool>
+                 && sizeof(K) <= 8
+                 && (std::is_integral_v<K> || std::numeric_limits<K>::is_iec559);
+
+template <typename I, typename Proj>
+using projected_key_t = std::remove_cvref_t<std::indirect_result_t<Proj&, I>>;
+
+// value type has to be default constructible for the scratch buffer
+template <typename I, typename Proj>
+concept radix_sortable = std::random_access_iterator<I>
+                      && radix_key<projected_key_t<I, Proj>>
+                      && std::default_initializable<std::iter_value_t<I>>;
+
+template <std::size_t N> struct unsigned_of;
+template <> struct unsigned_of<1> { using type = std::uint8_t;  };
+template <> struct unsigned_of<2> { using type = std::uint16_t; };
+template <> struct unsigned_of<4> { using type = std::uint32_t; };
+template <> struct unsigned_of<8> { using type = std::uint64_t; };
+
+// order preserving: sign bit flipped for signed integers, for floating
+// point negative values get all bits flipped, others the sign bit
+template <radix_key K>
+constexpr auto radix_bits(K k) {
+  using U = typename unsigned_of<sizeof(K)>::type;
+  constexpr U sign = U{1} << (8 * sizeof(K) - 1);
+  if constexpr (std::is_floating_point_v<K>) {
+    const auto u = std::bit_cast<U>(k);
+    return static_cast<U>(u & sign ? ~u : u | sign);
+  }
+  else if constexpr (std::is_signed_v<K>) {
+    return static_cast<U>(static_cast<U>(k) ^ sign);
+  }
+  else {
+    return static_cast<U>(k);
+  }
+}
+
+template <typename I, typename Proj>
+using radix_bits_t = decltype(radix_bits(std::declval<projected_key_t<I, Proj>>()));
+
+inline constexpr std::size_t radix_buckets = 256;
+using histogram = std::array<std::size_t, radix_buckets>;
+
+// digit of x at shift, mask of all ones sorts descending
+template <typename U, typename T, typename Proj>
+inline std::size_t radix_digit(const T& x, unsigned shift, U mask, Proj& proj) {
+  return ((radix_bits(std::invoke(proj, x)) ^ mask) >> shift) & 0xff;
+}
+
+// digit counts of [first, first+n). Four interleaved counters keep
+// increments of equal digits from waiting on each other.
+template <std::random_access_iterator I, typename U, typename Proj>
+histogram radix_histogram(I first, std::size_t n, unsigned shift, U mask, Proj& proj) {
+  std::array<histogram, 4> c{};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    ++c[0][radix_digit(first[i],     shift, mask, proj)];
+    ++c[1][radix_digit(first[i + 1], shift, mask, proj)];
+    ++c[2][radix_digit(first[i + 2], shift, mask, proj)];
+    ++c[3][radix_digit(first[i + 3], shift, mask, proj)];
+  }
+  for (; i < n; ++i) ++c[0][radix_digit(first[i], shift, mask, proj)];
+  for (std::size_t b = 0; b < radix_buckets; ++b) c[0][b] += c[1][b] + c[2][b] + c[3][b];
+  return c[0];
+}
+
+// moves [first, first+n) to dst[offset[digit]++]. Small trivially
+// copyable values are staged in a cache line per bucket first, so
+// destination lines are written whole rather than one value at a time.
+template <std::random_access_iterator I, std::random_access_iterator O, typename U, typename Proj>
+void radix_scatter(I first, std::size_t n, O dst, unsigned shift, U mask, Proj& proj, histogram& offset) {
+  using V = std::iter_value_t<I>;
+  if constexpr (std::is_trivially_copyable_v<V> && sizeof(V) <= 16) {
+    constexpr std::size_t line = std::max<std::size_t>(1u, 64 / sizeof(V));
+    std::array<std::array<V, line>, radix_buckets> wc;
+    std::array<std::uint8_t, radix_buckets> fill{};
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto b = radix_digit(first[i], shift, mask, proj);
+      wc[b][fill[b]++] = first[i];
+      if (fill[b] == line) {
+        std::copy_n(wc[b].begin(), line, dst + offset[b]);
+        offset[b] += line;
+        fill[b] = 0;
+      }
+    }
+    for (std::size_t b = 0; b < radix_buckets; ++b) {
+      std::copy_n(wc[b].begin(), fill[b], dst + offset[b]);
+      offset[b] += fill[b];
+    }
+  }
+  else {
+    for (std::size_t i = 0; i < n; ++i)
+      dst[offset[radix_digit(first[i], shift, mask, proj)]++] = std::move(first[i]);
+  }
+}
+
+} // namespace sorting
+} // namespace thp
+
+#endif // RADIX_HPP_
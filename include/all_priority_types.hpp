@@ -6,24 +6,62 @@
 
 #include "include/task_type.hpp"
 #include "include/task_queue.hpp"
+#include "include/mpmc_taskq.hpp"
+#include "include/bucket_taskq.hpp"
+#include "include/deadline.hpp"
+#include "include/deadline_taskq.hpp"
+#include "include/priority_levels.hpp"
 
 namespace thp {
 
-using AllPriorityTupleType = std::tuple<void>;
-using AllPriorityTupleType2 = std::tuple<
+// one task queue per type, scheduler serves queues in this order
+using AllPriorityTupleType = std::tuple<
 void,
 int,
+level,
 float,
 std::chrono::steady_clock::time_point,
-std::chrono::system_clock::time_point
+std::chrono::system_clock::time_point,
+deadline
 >;
 
+// task queue implementation for a priority type
+template<typename Prio>
+struct TaskQueueFor {
+  using type = priority_taskq<Prio>;
+};
+
+// small bounded priority range, O(1) buckets instead of heap
+template<bounded_priority Prio>
+struct TaskQueueFor<Prio> {
+  using type = bucket_taskq<Prio>;
+};
+
+// earliest time point first
+template<typename Clock, typename Duration>
+struct TaskQueueFor<std::chrono::time_point<Clock, Duration>> {
+  using Prio = std::chrono::time_point<Clock, Duration>;
+  using type = priority_taskq<Prio, std::greater<comparable_task<Prio>>>;
+};
+
+// earliest deadline first, with deadline miss policy
+template<>
+struct TaskQueueFor<deadline> {
+  using type = deadline_taskq;
+};
+
+// FIFO tasks don't need ordering, use lock free ring
+template<>
+struct TaskQueueFor<void> {
+  using type = mpmc_taskq;
+};
+
 template<typename T>
 struct TaskQueueTuple;
 
 template<typename...Ts>
 struct TaskQueueTuple<std::tuple<Ts...>> {
-  using type = std::tuple<priority_taskq<Ts>...>;
+  using type = std::tuple<typename TaskQueueFor<Ts>::type...>;
 };
 
 } // namespace thp
@@ -0,0 +1,138 @@
+#ifndef BUCKET_TASKQ_HPP_
+#define BUCKET_TASKQ_HPP_
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include "include/priority_levels.hpp"
+#include "include/task_queue.hpp"
+#include "include/traits.hpp"
+
+namespace thp {
+
+//
+// priority queue for bounded priority types, one FIFO per level and a bitmap
+// of non empty levels. Push and pop are O(1): highest non empty level is
+// found with a count-leading-zeros on the bitmap words. Unlike the heap,
+// tasks of equal priority run in submission order.
+//
+template <bounded_priority Prio>
+class bucket_taskq : public task_queue {
+  static constexpr std::size_t Levels = priority_levels_v<Prio>;
+  static constexpr std::size_t Words = (Levels + 63) / 64;
+
+public:
+  constexpr explicit bucket_taskq()
+  : mu{}
+  , bitmap{}
+  , buckets{}
+  , count{0}
+  {}
+
+  bucket_taskq(const bucket_taskq&) = delete;
+  bucket_taskq& operator = (const bucket_taskq&) = delete;
+
+  std::size_t pop(inplace_task& t) override {
+    std::lock_guard l(mu);
+    if (0u == count) return 0;
+    t = take(top_level());
+    return 1;
+  }
+
+  std::size_t pop_n(task_buffer& out, std::size_t n) override {
+    std::lock_guard l(mu);
+    n = std::min(n, count);
+    out.reserve(out.size() + n);
+    for (auto k = n; k > 0; ) {
+      // drain level by level, bitmap is scanned once per level
+      auto lvl = top_level();
+      auto& b = buckets[lvl];
+      auto m = std::min(k, b.size());
+      for (auto i = m; i > 0; --i) {
+        out.emplace_back(std::move(b.front()));
+        b.pop_front();
+      }
+      if (b.empty()) clear_bit(lvl);
+      count -= m;
+      k -= m;
+    }
+    return n;
+  }
+
+  template<typename... C>
+  std::size_t put(C&&... c) {
+    std::lock_guard l(mu);
+    std::size_t ret = 0;
+    ((ret += _insert(std::forward<C>(c))), ...);
+    return ret;
+  }
+
+  std::size_t len() const override {
+    std::lock_guard l(mu);
+    return count;
+  }
+
+  static constexpr std::size_t level_of(const Prio& p) {
+    using U = std::conditional_t<std::is_enum_v<Prio>, std::underlying_type<Prio>, std::type_identity<Prio>>::type;
+    auto v = static_cast<U>(p);
+    if constexpr (std::is_signed_v<U>) {
+      if (v < 0) return 0;
+    }
+    return std::min<std::size_t>(static_cast<std::size_t>(v), Levels - 1);
+  }
+
+  virtual ~bucket_taskq() = default;
+
+protected:
+  template <typename C>
+  std::size_t _insert(C&& t) {
+    using T = std::remove_cvref_t<C>;
+    if constexpr (traits::is_vector<T>::value) {
+      for (auto&& x : t) _insert(std::move(x));
+      return t.size();
+    }
+    else {
+      std::size_t lvl;
+      if constexpr (traits::is_unique_ptr<T>::value) lvl = level_of(t->get_priority());
+      else                                           lvl = level_of(t.get_priority());
+      buckets[lvl].emplace_back(to_inplace_task(std::forward<C>(t)));
+      bitmap[lvl / 64] |= std::uint64_t{1} << (lvl % 64);
+      ++count;
+      return 1;
+    }
+  }
+
+  // caller holds mu, count > 0
+  std::size_t top_level() const {
+    for (auto w = Words; w-- > 0; )
+      if (bitmap[w]) return w * 64 + std::bit_width(bitmap[w]) - 1;
+    return 0;
+  }
+
+  inplace_task take(std::size_t lvl) {
+    auto& b = buckets[lvl];
+    inplace_task t = std::move(b.front());
+    b.pop_front();
+    if (b.empty()) clear_bit(lvl);
+    --count;
+    return t;
+  }
+
+  void clear_bit(std::size_t lvl) {
+    bitmap[lvl / 64] &= ~(std::uint64_t{1} << (lvl % 64));
+  }
+
+  mutable std::mutex mu;
+  std::array<std::uint64_t, Words> bitmap;
+  std::array<std::deque<inplace_task>, Levels> buckets;
+  std::size_t count;
+};
+
+} // namespace thp
+
+#endif // BUCKET_TASKQ_HPP_
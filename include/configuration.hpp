@@ -1,12 +1,18 @@
 #ifndef CONFIGURATION_HPP__
 #define CONFIGURATION_HPP__
 
+#include <atomic>
 #include <memory>
 #include <pthread.h>
 #include <signal.h>
 #include <sstream>
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "platform/thread_config.h"
 
@@ -51,6 +57,36 @@ private:
   struct config *conf_;
 };
 
+// spin loop hint
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+// futex on an atomic word, unlike atomic::wait it takes a deadline.
+// Waiters and wakers of a word have to use these both.
+static_assert(sizeof(std::atomic<unsigned>) == sizeof(unsigned));
+
+inline void futex_wake_all(std::atomic<unsigned>& w) {
+  ::syscall(SYS_futex, &w, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+// blocks while w holds expected, false once deadline (steady clock) passed
+inline bool futex_wait_until(std::atomic<unsigned>& w, unsigned expected,
+                             std::chrono::steady_clock::time_point tp) {
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+  const timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+  ::syscall(SYS_futex, &w, FUTEX_WAIT_BITSET_PRIVATE, expected, &ts, nullptr, FUTEX_BITSET_MATCH_ANY);
+  return std::chrono::steady_clock::now() < tp;
+}
+
+inline void futex_wait(std::atomic<unsigned>& w, unsigned expected) {
+  ::syscall(SYS_futex, &w, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
 } // namespace platform
 
 namespace Static {
@@ -60,7 +96,18 @@ namespace Static {
   constexpr inline decltype(auto) scheduler_tick()           { return std::chrono::microseconds(10);   }
   constexpr inline decltype(auto) per_queue_capacity()       { return 16*1024;                         }
   constexpr inline decltype(auto) queue_table_capacity()     { return 1024;                            }
-  constexpr inline decltype(auto) stl_sort_cutoff()          { return 16*1024*1024u;                    }
+  constexpr inline decltype(auto) stl_sort_cutoff()          { return 64*1024u;                        }
+  constexpr inline decltype(auto) radix_sort_cutoff()        { return 4*1024u;                         }
+  constexpr inline decltype(auto) spin_before_park()         { return 2048u;                           }
+  constexpr inline decltype(auto) timer_tick()               { return std::chrono::milliseconds(1);    }
+  constexpr inline decltype(auto) batch_target()             { return std::chrono::microseconds(100);  }
+  constexpr inline decltype(auto) max_load_factor()          { return 64;                              }
+  constexpr inline decltype(auto) max_sched_linger()         { return std::chrono::microseconds(500);  }
+  constexpr inline decltype(auto) exec_sample_period()       { return 32u;                             }
+  constexpr inline decltype(auto) rebalance_period()         { return std::chrono::milliseconds(1);    }
+  constexpr inline decltype(auto) auto_trial_period()        { return std::chrono::milliseconds(20);   }
+  constexpr inline decltype(auto) auto_exploit_period()      { return std::chrono::milliseconds(1000); }
+  constexpr inline decltype(auto) help_wait_backoff()        { return std::chrono::microseconds(50);   }
 } // namespace Static
 
 } // namespace thp
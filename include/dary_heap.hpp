@@ -0,0 +1,112 @@
+#ifndef DARY_HEAP_HPP_
+#define DARY_HEAP_HPP_
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace thp {
+
+//
+// d-ary max heap, top is the largest element per Compare (like std::priority_queue)
+//
+// Wider nodes make tree shallower, log_d(N) levels, and D siblings share a
+// cache line or two, so sift down touches far fewer lines than a binary heap.
+// pop_n takes the k largest in O(k D log_d N) without touching the rest.
+// Sifts move a hole instead of swapping, one move per level.
+//
+template <typename T, typename Compare = std::less<T>, std::size_t D = 4>
+class dary_heap {
+  static_assert(D >= 2, "heap arity must be at least 2");
+
+public:
+  using value_type = T;
+
+  explicit dary_heap(Compare c = {})
+  : comp{std::move(c)}
+  , data{}
+  {}
+
+  std::size_t size() const { return data.size(); }
+  bool empty() const       { return data.empty(); }
+  const T& top() const     { return data.front(); }
+
+  void reserve(std::size_t n) { data.reserve(n); }
+  void clear()                { data.clear(); }
+
+  void push(T&& v) {
+    data.push_back(std::move(v));
+    sift_up(data.size() - 1);
+  }
+
+  // moves [first, last) in, heapifies once when batch is larger than heap
+  template <std::input_iterator I, std::sentinel_for<I> S>
+  void push(I first, S last) {
+    const auto old = data.size();
+    data.insert(data.end(), std::make_move_iterator(first), std::make_move_iterator(last));
+    if (data.size() - old > old) make_heap();
+    else for (auto i = old; i < data.size(); ++i) sift_up(i);
+  }
+
+  // precondition: !empty()
+  T pop() {
+    T ret = std::move(data.front());
+    T last = std::move(data.back());
+    data.pop_back();
+    if (!data.empty()) sift_down(0, std::move(last));
+    return ret;
+  }
+
+  // out(T&&) for up to k largest elements, in order, returns the count
+  template <typename Out>
+  std::size_t pop_n(std::size_t k, Out&& out) {
+    k = std::min(k, data.size());
+    for (std::size_t i = 0; i < k; ++i) out(pop());
+    return k;
+  }
+
+private:
+  void sift_up(std::size_t i) {
+    T v = std::move(data[i]);
+    while (i > 0) {
+      const auto p = (i - 1) / D;
+      if (!comp(data[p], v)) break;
+      data[i] = std::move(data[p]);
+      i = p;
+    }
+    data[i] = std::move(v);
+  }
+
+  void sift_down(std::size_t i, T&& v) {
+    const auto n = data.size();
+    for (;;) {
+      const auto first = D * i + 1;
+      if (first >= n) break;
+      auto best = first;
+      for (auto c = first + 1, e = std::min(first + D, n); c < e; ++c)
+        if (comp(data[best], data[c])) best = c;
+      if (!comp(v, data[best])) break;
+      data[i] = std::move(data[best]);
+      i = best;
+    }
+    data[i] = std::move(v);
+  }
+
+  // Floyd's bottom up construction, O(N)
+  void make_heap() {
+    if (data.size() < 2) return;
+    for (auto i = (data.size() - 2) / D + 1; i-- > 0; ) {
+      T v = std::move(data[i]);
+      sift_down(i, std::move(v));
+    }
+  }
+
+  Compare comp;
+  std::vector<T> data;
+};
+
+} // namespace thp
+
+#endif // DARY_HEAP_HPP_
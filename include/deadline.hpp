@@ -0,0 +1,55 @@
+#ifndef DEADLINE_HPP_
+#define DEADLINE_HPP_
+
+#include <chrono>
+#include <compare>
+#include <cstdint>
+
+#include "include/task_type.hpp"
+
+namespace thp {
+
+// absolute completion deadline, priority type of tasks with an SLA.
+// Own type so deadline tasks get their own queue, separate from time tasks
+// which use a time_point as start time. run is the task's expected run
+// time, zero leaves it to the queue's estimate (see deadline_taskq).
+struct deadline {
+  using clock = std::chrono::steady_clock;
+
+  clock::time_point at{};
+  clock::duration run{};
+
+  static deadline after(clock::duration d, clock::duration run = {}) { return {clock::now() + d, run}; }
+
+  bool passed(clock::time_point now = clock::now()) const { return now > at; }
+
+  // started at now, would it still finish in time
+  bool can_meet(clock::time_point now, clock::duration estimate) const {
+    return now + (run.count() > 0 ? run : estimate) <= at;
+  }
+
+  auto operator <=> (const deadline&) const = default;
+};
+
+// what to do with a task which can no longer meet its deadline when
+// dispatched: it is past it, or started now would finish after it
+enum class deadline_policy : uint8_t
+{
+  eKeep = 0,    // run it anyway, in deadline order
+  eDrop = 1,    // discard, its future gets broken_promise
+  eDemote = 2,  // run it after all on time deadline tasks
+};
+
+struct deadline_stats {
+  std::size_t met;        // completed by deadline
+  std::size_t missed;     // completed after deadline
+  std::size_t dropped;    // discarded by eDrop
+  std::size_t demoted;    // moved behind on time tasks by eDemote
+};
+
+template <typename Ret>
+using deadline_task = priority_task<Ret, deadline>;
+
+} // namespace thp
+
+#endif // DEADLINE_HPP_
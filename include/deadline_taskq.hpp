@@ -0,0 +1,183 @@
+#ifndef DEADLINE_TASKQ_HPP_
+#define DEADLINE_TASKQ_HPP_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "include/deadline.hpp"
+#include "include/dary_heap.hpp"
+#include "include/task_queue.hpp"
+#include "include/traits.hpp"
+
+namespace thp {
+
+//
+// earliest deadline first task queue
+//
+// Tasks are kept in a min heap on deadline. A task which can no longer
+// meet its deadline when popped, started now and running for its own
+// deadline::run or else the run time estimate, is handled per
+// deadline_policy: kept in order, dropped, or moved to a late FIFO served
+// only by pop_late(). Dispatched tasks are wrapped to count whether they
+// completed by their deadline.
+//
+class deadline_taskq : public task_queue {
+  using clock = deadline::clock;
+  using value_type = std::unique_ptr<comparable_task<deadline>>;
+
+  struct value_compare {
+    bool operator () (const value_type& x, const value_type& y) const {
+      return y->get_priority() < x->get_priority();
+    }
+  };
+
+public:
+  explicit deadline_taskq()
+  : mu{}
+  , tasks{}
+  , late{}
+  , policy{deadline_policy::eKeep}
+  , estimate{0}
+  , met{0}
+  , missed{0}
+  , dropped{0}
+  , demoted{0}
+  {}
+
+  deadline_taskq(const deadline_taskq&) = delete;
+  deadline_taskq& operator = (const deadline_taskq&) = delete;
+
+  std::size_t pop(inplace_task& t) override {
+    task_buffer out;
+    if (0u == pop_n(out, 1)) return 0;
+    t = std::move(out.front());
+    return 1;
+  }
+
+  // on time tasks first, then demoted ones
+  std::size_t pop_n(task_buffer& out, std::size_t n) override {
+    std::lock_guard l(mu);
+    auto got = take_on_time(out, n);
+    if (tasks.empty()) got += take_late(out, n - got);
+    return got;
+  }
+
+  // up to n tasks which can still meet their deadline, earliest first
+  std::size_t pop_on_time(task_buffer& out, std::size_t n) {
+    std::lock_guard l(mu);
+    return take_on_time(out, n);
+  }
+
+  // up to n demoted tasks, in order of demotion
+  std::size_t pop_late(task_buffer& out, std::size_t n) {
+    std::lock_guard l(mu);
+    return take_late(out, n);
+  }
+
+  template<typename... C>
+  std::size_t put(C&&... c) {
+    std::lock_guard l(mu);
+    std::size_t ret = 0;
+    ((ret += _insert(std::forward<C>(c))), ...);
+    return ret;
+  }
+
+  std::size_t len() const override {
+    std::lock_guard l(mu);
+    return tasks.size() + late.size();
+  }
+
+  void set_policy(deadline_policy p) {
+    policy.store(p, std::memory_order::relaxed);
+  }
+
+  // expected run time of tasks without their own, job queue sets it from
+  // the scheduler's measured task run time
+  void set_run_estimate(clock::duration d) {
+    estimate.store(d.count(), std::memory_order::relaxed);
+  }
+
+  deadline_stats stats() const {
+    return {met.load(std::memory_order::relaxed), missed.load(std::memory_order::relaxed),
+            dropped.load(std::memory_order::relaxed), demoted.load(std::memory_order::relaxed)};
+  }
+
+  virtual ~deadline_taskq() = default;
+
+protected:
+  template <typename C>
+  std::size_t _insert(C&& t) {
+    using T = std::remove_cvref_t<C>;
+    if constexpr (traits::is_vector<T>::value) {
+      for (auto&& x : t) _insert(std::move(x));
+      return t.size();
+    }
+    else if constexpr (traits::is_unique_ptr<T>::value) {
+      tasks.push(std::move(t));
+      return 1;
+    }
+    else {
+      tasks.push(std::make_unique<T>(std::move(t)));
+      return 1;
+    }
+  }
+
+  // caller holds mu
+  std::size_t take_on_time(task_buffer& out, std::size_t n) {
+    const auto now = clock::now();
+    const auto p = policy.load(std::memory_order::relaxed);
+    const clock::duration est{estimate.load(std::memory_order::relaxed)};
+    std::size_t got = 0;
+    while (got < n && !tasks.empty()) {
+      auto t = tasks.pop();
+      if (p != deadline_policy::eKeep && !t->get_priority().can_meet(now, est)) {
+        if (p == deadline_policy::eDrop) {
+          dropped.fetch_add(1, std::memory_order::relaxed);
+        }
+        else {
+          demoted.fetch_add(1, std::memory_order::relaxed);
+          late.emplace_back(std::move(t));
+        }
+        continue;
+      }
+      out.emplace_back(dispatch(std::move(t)));
+      ++got;
+    }
+    return got;
+  }
+
+  // caller holds mu
+  std::size_t take_late(task_buffer& out, std::size_t n) {
+    std::size_t got = 0;
+    for (; got < n && !late.empty(); ++got) {
+      out.emplace_back(dispatch(std::move(late.front())));
+      late.pop_front();
+    }
+    return got;
+  }
+
+  inplace_task dispatch(value_type&& t) {
+    return [this, p = std::move(t)] {
+      p->execute();
+      auto& c = p->get_priority().passed() ? missed : met;
+      c.fetch_add(1, std::memory_order::relaxed);
+    };
+  }
+
+  mutable std::mutex mu;
+  dary_heap<value_type, value_compare> tasks;
+  std::deque<value_type> late;
+  std::atomic<deadline_policy> policy;
+  std::atomic<clock::rep> estimate;
+  std::atomic<std::size_t> met;
+  std::atomic<std::size_t> missed;
+  std::atomic<std::size_t> dropped;
+  std::atomic<std::size_t> demoted;
+};
+
+} // namespace thp
+
+#endif // DEADLINE_TASKQ_HPP_
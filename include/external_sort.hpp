@@ -0,0 +1,453 @@
+#ifndef EXTERNAL_SORT_HPP_
+#define EXTERNAL_SORT_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "include/threadpool.hpp"
+
+namespace thp {
+
+struct external_sort_config {
+  // run files go here
+  std::filesystem::path temp_dir = std::filesystem::temp_directory_path();
+  // bytes of records held in memory while forming runs: a run is a third
+  // of it, one run is read while another is sorted with a scratch run
+  std::size_t memory_budget = 256u << 20;
+  // bytes per merge writer buffer (two per merge part), also how far
+  // ahead merge readers ask the kernel to read
+  std::size_t io_block = 4u << 20;
+  // independent merges of the output, 0 is one per pool worker
+  std::size_t merge_parts = 0;
+};
+
+struct external_sort_stats {
+  std::size_t records;
+  std::size_t runs;
+};
+
+namespace details {
+
+inline std::system_error os_error(const std::string& what) {
+  return std::system_error(errno, std::generic_category(), what);
+}
+
+// owns a file descriptor, writes whole buffers at an offset
+class file {
+public:
+  file() = default;
+  file(const std::filesystem::path& p, int flags, mode_t mode = 0644)
+  : fd{::open(p.c_str(), flags | O_CLOEXEC, mode)}
+  {
+    if (fd < 0) throw os_error("open " + p.string());
+  }
+  explicit file(int f) : fd{f} {}
+  file(file&& rhs) noexcept : fd{std::exchange(rhs.fd, -1)} {}
+  file& operator = (file&& rhs) noexcept {
+    if (this != &rhs) {
+      close();
+      fd = std::exchange(rhs.fd, -1);
+    }
+    return *this;
+  }
+  file(const file&) = delete;
+  file& operator = (const file&) = delete;
+  ~file() { close(); }
+
+  int handle() const { return fd; }
+
+  std::size_t size() const {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) throw os_error("fstat");
+    return static_cast<std::size_t>(st.st_size);
+  }
+
+  void resize(std::size_t n) {
+    if (::ftruncate(fd, static_cast<off_t>(n)) != 0) throw os_error("ftruncate");
+  }
+
+  void write_at(const void* p, std::size_t n, std::size_t off) {
+    auto b = static_cast<const char*>(p);
+    while (n > 0) {
+      const auto k = ::pwrite(fd, b, n, static_cast<off_t>(off));
+      if (k < 0) {
+        if (errno == EINTR) continue;
+        throw os_error("pwrite");
+      }
+      b += k;
+      off += static_cast<std::size_t>(k);
+      n -= static_cast<std::size_t>(k);
+    }
+  }
+
+private:
+  void close() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+  }
+
+  int fd{-1};
+};
+
+// read only mapping of a whole file
+class mapping {
+public:
+  mapping() = default;
+  explicit mapping(const file& f) : len{f.size()} {
+    if (0u == len) return;
+    addr = ::mmap(nullptr, len, PROT_READ, MAP_SHARED, f.handle(), 0);
+    if (addr == MAP_FAILED) {
+      addr = nullptr;
+      throw os_error("mmap");
+    }
+  }
+  mapping(mapping&& rhs) noexcept
+  : addr{std::exchange(rhs.addr, nullptr)}
+  , len{std::exchange(rhs.len, 0)}
+  {}
+  mapping& operator = (mapping&& rhs) noexcept {
+    if (this != &rhs) {
+      unmap();
+      addr = std::exchange(rhs.addr, nullptr);
+      len = std::exchange(rhs.len, 0);
+    }
+    return *this;
+  }
+  mapping(const mapping&) = delete;
+  mapping& operator = (const mapping&) = delete;
+  ~mapping() { unmap(); }
+
+  template <typename T>
+  const T* as() const { return static_cast<const T*>(addr); }
+  std::size_t size() const { return len; }
+
+  // madvise on [off, off+n), widened to pages, best effort
+  void advise(std::size_t off, std::size_t n, int advice) const {
+    if (!addr || off >= len) return;
+    static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto b = off / page * page;
+    const auto e = std::min(len, off + n);
+    ::madvise(static_cast<char*>(addr) + b, e - b, advice);
+  }
+
+private:
+  void unmap() {
+    if (addr) ::munmap(addr, len);
+    addr = nullptr;
+  }
+
+  void* addr{nullptr};
+  std::size_t len{0};
+};
+
+// file in dir, removed when closed
+class temp_file : public file {
+public:
+  temp_file() = default;
+  explicit temp_file(const std::filesystem::path& dir) {
+    auto name = (dir / "thp_run_XXXXXX").string();
+    const auto fd = ::mkstemp(name.data());
+    if (fd < 0) throw os_error("mkstemp " + name);
+    file::operator=(file(fd));
+    path = std::move(name);
+  }
+  temp_file(temp_file&& rhs) noexcept : file{std::move(rhs)}, path{std::exchange(rhs.path, {})} {}
+  temp_file& operator = (temp_file&& rhs) noexcept {
+    if (this != &rhs) {
+      remove();
+      file::operator=(std::move(rhs));
+      path = std::exchange(rhs.path, {});
+    }
+    return *this;
+  }
+  ~temp_file() { remove(); }
+
+private:
+  void remove() {
+    if (!path.empty()) ::unlink(path.c_str());
+    path.clear();
+  }
+
+  std::string path;
+};
+
+} // namespace details
+
+//
+// sorts a file of fixed size records which needn't fit in memory, on
+// pool workers.
+//
+// Runs: input is mapped, memory_budget/3 bytes at a time are copied out,
+// sorted by threadpool::sort and spilled to a temp file. Two run buffers
+// take turns, so while one run is sorted the previous one is written and
+// the next one read by another worker.
+//
+// Merge: splitter keys sampled from all runs cut the output in
+// merge_parts ranges, each run is cut at the same keys by binary search,
+// so every part is a k-way merge of its own run pieces into its own
+// range of the output, all parts in parallel. Readers walk mapped runs
+// and ask the kernel to read one io_block ahead and drop what's behind.
+// Writer fills one buffer while the other is written by a pool worker.
+//
+template <typename T, typename Comp = std::ranges::less, typename Proj = std::identity>
+requires std::is_trivially_copyable_v<T> && std::sortable<T*, Comp, Proj>
+class external_sorter {
+public:
+  explicit external_sorter(threadpool& pool, external_sort_config c = {}, Comp comp = {}, Proj proj = {})
+  : tp{pool}
+  , cfg{std::move(c)}
+  , cmp{std::move(comp)}
+  , prj{std::move(proj)}
+  {}
+
+  // records of in sorted into out, in and out must differ. Throws
+  // std::invalid_argument when they don't or in isn't whole records,
+  // std::system_error on I/O errors.
+  external_sort_stats sort(const std::filesystem::path& in, const std::filesystem::path& out) {
+    // out is truncated before in is read
+    std::error_code ec;
+    if (std::filesystem::equivalent(in, out, ec)) throw std::invalid_argument("external_sorter: " + in.string() + " is both input and output");
+    details::file src(in, O_RDONLY);
+    const auto bytes = src.size();
+    if (bytes % sizeof(T) != 0) throw std::invalid_argument("external_sorter: size of " + in.string() + " isn't a multiple of record size");
+    const auto n = bytes / sizeof(T);
+
+    details::file dst(out, O_RDWR | O_CREAT | O_TRUNC);
+    if (0u == n) return {0, 0};
+    dst.resize(bytes);
+
+    const details::mapping input(src);
+    input.advise(0, bytes, MADV_SEQUENTIAL);
+    auto runs = make_runs(input, n, dst);
+    if (runs.size() > 1) merge(runs, dst);
+    return {n, runs.size()};
+  }
+
+private:
+  std::size_t run_records() const {
+    return std::max<std::size_t>(1u, cfg.memory_budget / (3 * sizeof(T)));
+  }
+
+  // sorted runs in temp files, single run goes straight to dst
+  std::vector<details::temp_file> make_runs(const details::mapping& input, std::size_t n, details::file& dst) {
+    const auto per_run = run_records();
+    const auto nruns = (n + per_run - 1) / per_run;
+    std::vector<details::temp_file> runs(nruns);
+    std::vector<T> buf[2];
+
+    auto load = [&](std::size_t r, std::vector<T>& b) {
+      const auto first = r * per_run;
+      b.resize(std::min(per_run, n - first));
+      std::memcpy(b.data(), input.as<T>() + first, b.size() * sizeof(T));
+      input.advise(first * sizeof(T), b.size() * sizeof(T), MADV_DONTNEED);
+    };
+    auto spill = [&](std::size_t r, const std::vector<T>& b) {
+      if (nruns == 1) return dst.write_at(b.data(), b.size() * sizeof(T), 0);
+      details::temp_file f(cfg.temp_dir);
+      f.write_at(b.data(), b.size() * sizeof(T), 0);
+      runs[r] = std::move(f);
+    };
+
+    load(0, buf[0]);
+    for (std::size_t r = 0; r < nruns; ++r) {
+      auto& cur = buf[r % 2];
+      auto& other = buf[(r + 1) % 2];
+      auto [io] = tp.enqueue([&, r] {
+        if (r > 0) spill(r - 1, other);
+        if (r + 1 < nruns) load(r + 1, other);
+      });
+      auto [sorted] = tp.sort(cur.begin(), cur.end(), cmp, prj);
+      // both are waited for before an exception leaves, tasks use buf
+      std::exception_ptr ex;
+      try { tp.get(sorted); } catch(...) { ex = std::current_exception(); }
+      tp.get(io);
+      if (ex) std::rethrow_exception(ex);
+    }
+    spill(nruns - 1, buf[(nruns - 1) % 2]);
+    return runs;
+  }
+
+  struct piece {
+    const T* cur;
+    const T* end;
+    const details::mapping* map;
+    const T* dropped;   // records before it were merged and dropped
+    const T* advised;   // records before it were asked to be read
+  };
+
+  // a block ahead of cur is asked to be read once less than half a block
+  // is left, records merged since last time are dropped
+  void prefetch(piece& p, std::size_t block) const {
+    if (p.advised == p.end || p.cur + block / 2 < p.advised) return;
+    const auto base = p.map->template as<T>();
+    const auto at = static_cast<std::size_t>(p.cur - base);
+    if (p.dropped < p.cur) {
+      const auto from = static_cast<std::size_t>(p.dropped - base);
+      p.map->advise(from * sizeof(T), (at - from) * sizeof(T), MADV_DONTNEED);
+      p.dropped = p.cur;
+    }
+    const auto n = std::min<std::size_t>(2 * block, static_cast<std::size_t>(p.end - p.cur));
+    p.map->advise(at * sizeof(T), n * sizeof(T), MADV_WILLNEED);
+    p.advised = p.cur + n;
+  }
+
+  void merge(std::vector<details::temp_file>& runs, details::file& dst) {
+    std::vector<details::mapping> maps;
+    maps.reserve(runs.size());
+    for (auto& r : runs) maps.emplace_back(r);
+
+    const auto parts = cfg.merge_parts ? cfg.merge_parts : std::max<std::size_t>(1u, tp.num_workers());
+    auto cuts = split(maps, parts);
+
+    std::vector<std::future<void>> merges;
+    for (std::size_t p = 0; p < parts; ++p) {
+      std::size_t off = 0;
+      std::vector<piece> pieces;
+      for (std::size_t r = 0; r < maps.size(); ++r) {
+        off += cuts[r][p];
+        auto base = maps[r].template as<T>();
+        if (cuts[r][p] < cuts[r][p + 1])
+          pieces.push_back({base + cuts[r][p], base + cuts[r][p + 1], &maps[r], base + cuts[r][p], base + cuts[r][p]});
+      }
+      auto [f] = tp.enqueue([this, &dst, off, pieces = std::move(pieces)] () mutable {
+        merge_part(pieces, dst, off);
+      });
+      merges.emplace_back(std::move(f));
+    }
+    std::exception_ptr ex;
+    for (auto& f : merges) {
+      try { tp.get(f); } catch(...) { if (!ex) ex = std::current_exception(); }
+    }
+    if (ex) std::rethrow_exception(ex);
+  }
+
+  // cuts[r][p], p in [0, parts], start of part p in run r. Parts are cut at
+  // sampled keys, lower bound in every run, so equal keys share a part.
+  std::vector<std::vector<std::size_t>> split(const std::vector<details::mapping>& maps, std::size_t parts) const {
+    constexpr std::size_t per_run = 64;
+    std::vector<T> samples;
+    for (auto& m : maps) {
+      const auto k = m.size() / sizeof(T);
+      const auto s = std::min(k, per_run * parts);
+      for (std::size_t i = 0; i < s; ++i) samples.push_back(m.as<T>()[i * k / s]);
+    }
+    std::ranges::sort(samples, cmp, prj);
+
+    std::vector<std::vector<std::size_t>> cuts(maps.size(), std::vector<std::size_t>(parts + 1));
+    for (std::size_t r = 0; r < maps.size(); ++r) {
+      const auto base = maps[r].as<T>();
+      const auto k = maps[r].size() / sizeof(T);
+      cuts[r][parts] = k;
+      for (std::size_t p = 1; p < parts; ++p) {
+        const auto& key = std::invoke(prj, samples[p * samples.size() / parts]);
+        const auto it = std::ranges::lower_bound(base + cuts[r][p - 1], base + k, key, cmp, prj);
+        cuts[r][p] = static_cast<std::size_t>(it - base);
+      }
+    }
+    return cuts;
+  }
+
+  // k-way merge of pieces into dst from record off on
+  void merge_part(std::vector<piece>& pieces, details::file& dst, std::size_t off) {
+    const auto block = std::max<std::size_t>(1u, cfg.io_block / sizeof(T));
+    for (auto& p : pieces) prefetch(p, block);
+
+    // smallest head on top, ties by piece index keep runs in order
+    auto later = [this, &pieces](std::size_t a, std::size_t b) {
+      const auto& x = std::invoke(prj, *pieces[a].cur);
+      const auto& y = std::invoke(prj, *pieces[b].cur);
+      if (std::invoke(cmp, y, x)) return true;
+      if (std::invoke(cmp, x, y)) return false;
+      return a > b;
+    };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heads(later);
+    for (std::size_t i = 0; i < pieces.size(); ++i) heads.push(i);
+
+    writer w{tp, dst, off * sizeof(T), block};
+    while (!heads.empty()) {
+      const auto i = heads.top();
+      heads.pop();
+      auto& p = pieces[i];
+      w.put(*p.cur++);
+      if (p.cur != p.end) {
+        prefetch(p, block);
+        heads.push(i);
+      }
+    }
+    w.finish();
+  }
+
+  // fills one buffer while a pool worker writes the other
+  struct writer {
+    writer(threadpool& pool, details::file& f, std::size_t at, std::size_t records)
+    : tp{pool}, out{f}, off{at}, cap{records}, bufs{std::vector<T>(records), std::vector<T>(records)}
+    {}
+
+    // only left without finish() while an exception unwinds: the write in
+    // flight has to end before buffers go away, its own error is dropped
+    // in favour of the one already propagating
+    ~writer() {
+      if (!pending.valid()) return;
+      try { pending.get(); } catch(...) {}
+    }
+
+    void put(const T& x) {
+      bufs[cur][fill++] = x;
+      if (fill == cap) flush();
+    }
+
+    // writes what's buffered and waits for it, a failed write throws here
+    void finish() {
+      flush();
+      if (pending.valid()) tp.get(pending);
+    }
+
+  private:
+    void flush() {
+      if (0u == fill) return;
+      if (pending.valid()) tp.get(pending);
+      auto [f] = tp.enqueue([&out = out, data = bufs[cur].data(), n = fill * sizeof(T), at = off] {
+        out.write_at(data, n, at);
+      });
+      pending = std::move(f);
+      off += fill * sizeof(T);
+      cur ^= 1u;
+      fill = 0;
+    }
+
+    threadpool& tp;
+    details::file& out;
+    std::size_t off;
+    std::size_t cap;
+    std::vector<T> bufs[2];
+    unsigned cur{0};
+    std::size_t fill{0};
+    std::future<void> pending{};
+  };
+
+  threadpool& tp;
+  external_sort_config cfg;
+  Comp cmp;
+  Proj prj;
+};
+
+} // namespace thp
+
+#endif // EXTERNAL_SORT_HPP_
@@ -0,0 +1,292 @@
+#ifndef THP_FUTURE_HPP_
+#define THP_FUTURE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "include/configuration.hpp"
+#include "include/inplace_task.hpp"
+#include "include/memory_pool.hpp"
+
+namespace thp {
+
+template <typename T> class future;
+template <typename T> class promise;
+
+namespace details {
+
+// optional value holder, void is just a flag
+template <typename T>
+struct value_holder {
+  std::optional<T> v;
+  template <typename... U> void set(U&&... u) { v.emplace(std::forward<U>(u)...); }
+  T take() { return std::move(*v); }
+};
+
+template <>
+struct value_holder<void> {
+  void set() {}
+  void take() {}
+};
+
+//
+// state shared by one promise and one future, allocated from block pool.
+// state word: bit 0 ready, bit 1 continuation attached, bit 2 somebody
+// waits on futex. Completer and then() race on it with fetch_or, whoever
+// comes second runs the continuation, so no lock is needed.
+//
+template <typename T>
+struct shared_state {
+  enum : unsigned { eReady = 1u, eContinuation = 2u, eWaiters = 4u };
+
+  std::atomic<unsigned> state{0};
+  std::atomic<unsigned> refs{2};
+  value_holder<T> value{};
+  std::exception_ptr ex{};
+  inplace_task continuation{};
+
+  bool ready() const { return state.load(std::memory_order::acquire) & eReady; }
+
+  void publish() {
+    auto prev = state.fetch_or(eReady, std::memory_order::acq_rel);
+    if (prev & eWaiters) platform::futex_wake_all(state);
+    if (prev & eContinuation) std::exchange(continuation, {})();
+  }
+
+  void attach(inplace_task&& t) {
+    continuation = std::move(t);
+    auto prev = state.fetch_or(eContinuation, std::memory_order::acq_rel);
+    if (prev & eReady) std::exchange(continuation, {})();
+  }
+
+  // spin first, futex park later
+  void wait() {
+    for (unsigned i = 0; i < Static::spin_before_park(); ++i) {
+      if (ready()) return;
+      platform::cpu_relax();
+    }
+    auto s = state.fetch_or(eWaiters, std::memory_order::acq_rel) | eWaiters;
+    while (!(s & eReady)) {
+      platform::futex_wait(state, s);
+      s = state.load(std::memory_order::acquire);
+    }
+  }
+
+  // same, false if tp (steady clock) passed first
+  bool wait_until(std::chrono::steady_clock::time_point tp) {
+    auto s = state.fetch_or(eWaiters, std::memory_order::acq_rel) | eWaiters;
+    while (!(s & eReady)) {
+      if (!platform::futex_wait_until(state, s, tp)) return ready();
+      s = state.load(std::memory_order::acquire);
+    }
+    return true;
+  }
+
+  void release() {
+    if (refs.fetch_sub(1, std::memory_order::acq_rel) == 1)
+      memory::pool_delete(this);
+  }
+};
+
+} // namespace details
+
+struct future_error_ex final : std::exception {
+  const char *what() const noexcept override { return "future_error_ex: no state"; }
+};
+
+//
+// lightweight single consumer future, see promise below
+//
+template <typename T>
+class future {
+  friend class promise<T>;
+  using state_t = details::shared_state<T>;
+
+  explicit future(state_t* s) : st{s} {}
+
+public:
+  using value_type = T;
+
+  future() noexcept = default;
+  future(future&& rhs) noexcept : st{std::exchange(rhs.st, nullptr)} {}
+  future& operator = (future&& rhs) noexcept {
+    if (this != &rhs) {
+      if (st) st->release();
+      st = std::exchange(rhs.st, nullptr);
+    }
+    return *this;
+  }
+
+  future(const future&) = delete;
+  future& operator = (const future&) = delete;
+
+  ~future() { if (st) st->release(); }
+
+  bool valid() const noexcept { return st != nullptr; }
+  bool is_ready() const       { return st && st->ready(); }
+
+  void wait() const {
+    if (!st) throw future_error_ex();
+    if (!st->ready()) st->wait();
+  }
+
+  template <typename Rep, typename Period>
+  std::future_status wait_for(const std::chrono::duration<Rep, Period>& dur) const {
+    return wait_until(std::chrono::steady_clock::now() + dur);
+  }
+
+  template <typename Clock, typename Duration>
+  std::future_status wait_until(const std::chrono::time_point<Clock, Duration>& tp) const {
+    if (!st) throw future_error_ex();
+    if (st->ready()) return std::future_status::ready;
+    // other clocks are turned into a steady deadline once
+    const auto deadline = std::chrono::steady_clock::now() + (tp - Clock::now());
+    return st->wait_until(std::chrono::time_point_cast<std::chrono::steady_clock::duration>(deadline))
+         ? std::future_status::ready : std::future_status::timeout;
+  }
+
+  // consumes the future
+  T get() {
+    wait();
+    auto s = std::exchange(st, nullptr);
+    struct releaser { state_t* s; ~releaser() { s->release(); } } r{s};
+    if (s->ex) std::rethrow_exception(s->ex);
+    return s->value.take();
+  }
+
+  // run fn(T) once value is ready, on the thread which completes this future
+  // (or right away, if it's already complete). Exception skips fn and is
+  // forwarded to the returned future.
+  template <typename Fn>
+  auto then(Fn&& fn) && {
+    return std::move(*this).then([](inplace_task&& t) { t(); }, std::forward<Fn>(fn));
+  }
+
+  // same, but continuation is handed to executor, any void(inplace_task&&) callable
+  template <typename Executor, typename Fn>
+  requires std::invocable<Executor&, inplace_task&&>
+  auto then(Executor&& ex, Fn&& fn) && {
+    using U = std::remove_cvref_t<decltype(invoke_with_value(fn, std::declval<future&>()))>;
+    if (!st) throw future_error_ex();
+
+    promise<U> p;
+    auto ret = p.get_future();
+    auto s = st;
+    s->attach([ex = std::forward<Executor>(ex), fn = std::forward<Fn>(fn), p = std::move(p), self = std::move(*this)] () mutable {
+      std::invoke(ex, inplace_task([fn = std::move(fn), p = std::move(p), self = std::move(self)] () mutable {
+        p.set_from([&] { return invoke_with_value(fn, self); });
+      }));
+    });
+    return ret;
+  }
+
+private:
+  template <typename Fn>
+  static decltype(auto) invoke_with_value(Fn& fn, future& f) {
+    if constexpr (std::is_void_v<T>) {
+      f.get();
+      return std::invoke(fn);
+    }
+    else {
+      return std::invoke(fn, f.get());
+    }
+  }
+
+  state_t* st{nullptr};
+};
+
+template <typename T>
+class promise {
+  using state_t = details::shared_state<T>;
+
+public:
+  promise() : st{memory::pool_new<state_t>()} {}
+  // no state, like a moved from promise, e.g. a slot filled in later
+  explicit promise(std::nullptr_t) noexcept {}
+  promise(promise&& rhs) noexcept
+  : st{std::exchange(rhs.st, nullptr)}
+  , retrieved{rhs.retrieved}
+  {}
+
+  promise& operator = (promise&& rhs) noexcept {
+    if (this != &rhs) {
+      abandon();
+      st = std::exchange(rhs.st, nullptr);
+      retrieved = rhs.retrieved;
+    }
+    return *this;
+  }
+
+  promise(const promise&) = delete;
+  promise& operator = (const promise&) = delete;
+
+  ~promise() { abandon(); }
+
+  bool valid() const noexcept { return st != nullptr; }
+
+  future<T> get_future() {
+    if (!st || retrieved) throw future_error_ex();
+    retrieved = true;
+    return future<T>(st);
+  }
+
+  // both throw future_error_ex once result is set or promise moved from
+  template <typename... U>
+  void set_value(U&&... u) {
+    if (!st) throw future_error_ex();
+    st->value.set(std::forward<U>(u)...);
+    finish();
+  }
+
+  void set_exception(std::exception_ptr e) {
+    if (!st) throw future_error_ex();
+    st->ex = std::move(e);
+    finish();
+  }
+
+  // stores fn() or exception thrown by it
+  template <typename Fn>
+  void set_from(Fn&& fn) {
+    try {
+      if constexpr (std::is_void_v<T>) {
+        std::invoke(std::forward<Fn>(fn));
+        set_value();
+      }
+      else {
+        set_value(std::invoke(std::forward<Fn>(fn)));
+      }
+    }
+    catch(...) {
+      if (st) set_exception(std::current_exception());
+    }
+  }
+
+private:
+  // waiter may destroy *this as soon as the state is published, only
+  // locals are touched after it
+  void finish() {
+    auto s = std::exchange(st, nullptr);
+    const bool drop_future_ref = !retrieved;
+    s->publish();
+    if (drop_future_ref) s->release();
+    s->release();
+  }
+
+  void abandon() {
+    if (!st) return;
+    set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+  }
+
+  state_t* st{nullptr};
+  bool retrieved{false};
+};
+
+} // namespace thp
+
+#endif // THP_FUTURE_HPP_
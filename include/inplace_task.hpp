@@ -0,0 +1,114 @@
+#ifndef INPLACE_TASK_HPP_
+#define INPLACE_TASK_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "include/memory_pool.hpp"
+
+namespace thp {
+
+//
+// type erased, move only void() callable with inline storage
+// no virtual inheritance, one table of function pointers per callable type.
+// Callables bigger than inline buffer, over aligned or with throwing move
+// live in a pooled block (see memory_pool.hpp) and only pointer is inline.
+// sizeof(inplace_task) == 128, two cache lines.
+//
+class inplace_task {
+public:
+  static constexpr std::size_t capacity = 112;
+  static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+  template <typename Fn>
+  static constexpr bool fits_inline = sizeof(Fn) <= capacity
+                                      && alignof(Fn) <= alignment
+                                      && std::is_nothrow_move_constructible_v<Fn>;
+
+  constexpr inplace_task() noexcept : buf{}, ops{nullptr} {}
+
+  template <typename Fn>
+  requires (!std::same_as<std::remove_cvref_t<Fn>, inplace_task>)
+           && std::invocable<std::remove_cvref_t<Fn>&>
+  inplace_task(Fn&& fn)
+  : ops{&table_for<std::remove_cvref_t<Fn>>}
+  {
+    using F = std::remove_cvref_t<Fn>;
+    if constexpr (fits_inline<F>) ::new (static_cast<void*>(buf)) F(std::forward<Fn>(fn));
+    else                          ::new (static_cast<void*>(buf)) F*(memory::pool_new<F>(std::forward<Fn>(fn)));
+  }
+
+  inplace_task(inplace_task&& rhs) noexcept : ops{rhs.ops} {
+    if (ops) {
+      ops->move(buf, rhs.buf);
+      rhs.ops = nullptr;
+    }
+  }
+
+  inplace_task& operator = (inplace_task&& rhs) noexcept {
+    if (this != &rhs) {
+      reset();
+      if (rhs.ops) {
+        rhs.ops->move(buf, rhs.buf);
+        ops = std::exchange(rhs.ops, nullptr);
+      }
+    }
+    return *this;
+  }
+
+  inplace_task(const inplace_task&) = delete;
+  inplace_task& operator = (const inplace_task&) = delete;
+
+  ~inplace_task() { reset(); }
+
+  void operator()() { ops->invoke(buf); }
+
+  explicit operator bool() const noexcept { return ops != nullptr; }
+
+  void reset() noexcept {
+    if (ops) {
+      ops->destroy(buf);
+      ops = nullptr;
+    }
+  }
+
+private:
+  struct vtable {
+    void (*invoke)(void*);
+    void (*move)(void* dst, void* src) noexcept;
+    void (*destroy)(void*) noexcept;
+  };
+
+  template <typename F>
+  static constexpr vtable table_for = [] {
+    if constexpr (fits_inline<F>) {
+      return vtable{
+        [](void* p) { std::invoke(*static_cast<F*>(p)); },
+        [](void* dst, void* src) noexcept {
+          ::new (dst) F(std::move(*static_cast<F*>(src)));
+          static_cast<F*>(src)->~F();
+        },
+        [](void* p) noexcept { static_cast<F*>(p)->~F(); }
+      };
+    }
+    else {
+      return vtable{
+        [](void* p) { std::invoke(**static_cast<F**>(p)); },
+        [](void* dst, void* src) noexcept { ::new (dst) F*(*static_cast<F**>(src)); },
+        [](void* p) noexcept { memory::pool_delete(*static_cast<F**>(p)); }
+      };
+    }
+  }();
+
+  alignas(alignment) std::byte buf[capacity];
+  const vtable* ops;
+};
+
+static_assert(sizeof(inplace_task) == 128);
+
+} // namespace thp
+
+#endif // INPLACE_TASK_HPP_
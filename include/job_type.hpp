@@ -1,52 +1,62 @@
 #ifndef JOB_TYPE_HPP__
 #define JOB_TYPE_HPP__
 
-#include <vector>
-#include <mutex>
-#include <condition_variable>
-#include <chrono>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
 
 #include "include/task_type.hpp"
+#include "include/traits.hpp"
 //#include "include/concepts.hpp"
 #include "include/managed_stop_token.hpp"
 
 namespace thp {
 //
-// TODO: job is an iterable graph, where each node is a computational point(task)
-// e.g. rng::for_each(job, [](auto&& task) { task.execute(); });
-// non-cyclic graph, where sequential operation will be queued, while parallel operations
-// can be queued in group and executed parallely by tp
-//
-// Define functional construct to build graph topology 
+// job is a flat set of independent tasks, tasks depending on each other
+// go in a task_graph (see task_graph.hpp)
 //
 
+// how job tasks are split among workers running it, like OpenMP schedule()
+enum class loop_schedule : uint8_t
+{
+  eStatic = 0,   // chunks dealt round robin to worker slots up front, default
+                 // chunk is an equal share per worker
+  eDynamic = 1,  // next chunk from an atomic cursor, default chunk 1
+  eGuided = 2,   // like eDynamic, chunk is remaining / workers, but not
+                 // below the chunk given, default 1
+};
+
 template<typename TaskType, typename TaskContainer = std::vector<TaskType>>
 struct job {
+  // claim state of one run, shared with helper tasks which may outlive the
+  // job. Helper touches job only while it holds an unfinished task index,
+  // and threadpool::run waits for all of those. Every run gets a fresh one,
+  // a late helper of an earlier run finds its own cursor exhausted.
+  struct cursor {
+    std::atomic<std::size_t> next{0};
+    // eStatic: worker slots handed out so far
+    std::atomic<std::size_t> slot{0};
+    std::size_t size{0};
+    std::size_t participants{1};
+    loop_schedule mode{loop_schedule::eDynamic};
+    std::size_t chunk{0};
+  };
+
   constexpr explicit job(std::vector<TaskType>&& data)
-  : mu{}
-  //, knt{0}
-  , workers{0}
-  //, wait_cv{}
+  : workers{0}
+  , mode{loop_schedule::eDynamic}
+  , chunk{0}
   , tasks{std::move(data)}
+  , claims{}
+  , ran{false}
   {}
 
-  job(job&& rhs) {
-    std::unique_lock lk(mu, std::defer_lock), rhs_lk(rhs.mu, std::defer_lock);
-    std::lock(lk, rhs_lk);
-    //std::swap(idx, rhs.idx);
-    std::swap(workers, rhs.workers);
-    std::swap(tasks, rhs.tasks);
-  }
-
-  job& operator = (job&& rhs) {
-    std::unique_lock lk(mu, std::defer_lock), rhs_lk(rhs.mu, std::defer_lock);
-    std::lock(lk, rhs_lk);
-    idx = rhs.idx;
-    workers = rhs.workers;
-    tasks = std::move(rhs.workers);
-    return *this;
-  }
+  job(job&&) = default;
+  job& operator = (job&&) = default;
 
   job(const job&) = delete;
   job& operator = (const job&) = delete;
@@ -61,43 +71,91 @@ struct job {
   template<typename TimePoint>
   constexpr job& run_until(TimePoint&& tp) { return std::move(*this); }
 
+  // most pool workers running this job at a time, 0 is all
   constexpr decltype(auto) num_workers(std::size_t w) {
     workers = w;
     return std::move(*this);
   }
   constexpr std::size_t num_workers() const { return workers; }
 
-  decltype(auto) worker_fn(managed_stop_token st) {
-    const auto n = tasks.size();
-    const thread_local auto my_idx = std::atomic_fetch_add_explicit(&idx, 1, std::memory_order::acq_rel);
-    for(auto i = my_idx; i < n; i += workers) {
-      {
-        if (st.stop_requested()) [[unlikely]] break;
-        //std::cerr << std::this_thread::get_id() << "work[" << i << "] " << idx << " " << tasks.size() << "\n";
+  // chunk 0 is the schedule's default
+  constexpr decltype(auto) schedule(loop_schedule s, std::size_t k = 0) {
+    mode = s;
+    chunk = k;
+    return std::move(*this);
+  }
+
+  std::size_t size() const { return tasks.size(); }
+
+  // before futures() and any runner of a run, participants is the number
+  // of runners. Tasks of an earlier run are reset to run again.
+  void prepare(std::size_t participants) {
+    if (ran) for (auto& t : tasks) t.reset();
+    ran = true;
+    auto c = std::make_shared<cursor>();
+    c->size = tasks.size();
+    c->participants = std::max<std::size_t>(1u, participants);
+    c->mode = mode;
+    c->chunk = chunk;
+    claims = std::move(c);
+  }
+
+  // callable which claims and runs tasks till none is left, any number of
+  // them can run concurrently. A static slot is run by whichever runner
+  // claims it, so a helper which never gets a worker doesn't strand tasks.
+  decltype(auto) runner() {
+    return [c = claims, this] {
+      const auto n = c->size;
+      const auto p = c->participants;
+      switch (c->mode) {
+      case loop_schedule::eStatic: {
+        const auto k = c->chunk ? c->chunk : std::max<std::size_t>(1u, (n + p - 1) / p);
+        for (auto s = c->slot.fetch_add(1); s < p; s = c->slot.fetch_add(1))
+          for (auto b = s * k; b < n; b += p * k) run_range(b, std::min(b + k, n));
+        return;
       }
-      tasks[i].execute();
-    }
-    //std::atomic_fetch_add_explicit(&knt, 1, std::memory_order::acq_rel);
-    //wait_cv.notify_one();
+      case loop_schedule::eDynamic: {
+        const auto k = std::max<std::size_t>(1u, c->chunk);
+        for (auto b = c->next.fetch_add(k); b < n; b = c->next.fetch_add(k))
+          run_range(b, std::min(b + k, n));
+        return;
+      }
+      case loop_schedule::eGuided: {
+        const auto min_k = std::max<std::size_t>(1u, c->chunk);
+        auto b = c->next.load(std::memory_order::relaxed);
+        for (;;) {
+          if (b >= n) return;
+          const auto k = std::max(min_k, (n - b + p - 1) / p);
+          if (!c->next.compare_exchange_weak(b, b + k, std::memory_order::relaxed)) continue;
+          run_range(b, std::min(b + k, n));
+          b = c->next.load(std::memory_order::relaxed);
+        }
+      }
+      }
+    };
   }
 
-  template<typename Oiter>
+  // Future: std::future or thp::future, after prepare(), before any task runs
+  template<template<typename> class Future = std::future, typename Oiter>
   constexpr decltype(auto) futures(Oiter o) {
-    return std::ranges::transform(tasks, o, [](auto&& t) { return t.future(); });
+    return std::ranges::transform(tasks, o, [](auto&& t) {
+      if constexpr (traits::is_thp_future_v<Future>) return t.lite_future();
+      else                                           return t.future();
+    });
   }
 
-  constexpr void wait() {
-    //std::unique_lock l(mu);
-    //wait_cv.wait(l, [&] { return knt.load(std::memory_order::relaxed) == idx.load(std::memory_order::relaxed); });
+private:
+  void run_range(std::size_t b, std::size_t e) {
+    for (; b < e; ++b) tasks[b].execute();
   }
 
-private:
   //boost::adjacency_list<TaskType, VecS, VecS> tasks;
-  mutable std::mutex mu;
-  std::atomic<int> idx;
   std::size_t workers;
-  //std::condition_variable_any wait_cv;
+  loop_schedule mode;
+  std::size_t chunk;
   TaskContainer tasks;
+  std::shared_ptr<cursor> claims;
+  bool ran;
 };
 
 
@@ -10,6 +10,7 @@
 #include <type_traits>
 #include <chrono>
 #include <array>
+#include <random>
 
 #include "include/scheduler.hpp"
 #include "include/traits.hpp"
@@ -19,6 +20,13 @@
 #include "include/util.hpp"
 #include "include/all_priority_types.hpp"
 #include "include/managed_stop_token.hpp"
+#include "include/pool_config.hpp"
+#include "include/ws_deque.hpp"
+#include "include/parking_lot.hpp"
+#include "include/inplace_task.hpp"
+#include "include/task_buffer.hpp"
+#include "include/memory_pool.hpp"
+#include "include/timer_service.hpp"
 
 namespace thp {
 
@@ -35,33 +43,159 @@ template <typename TaskQueueTupleType>
 class job_queue {
   static const auto NumQs = std::tuple_size_v<TaskQueueTupleType>;
 
+  // per worker state in work stealing mode
+  struct worker_state {
+    explicit worker_state(job_queue* q, unsigned id)
+    : owner{q}
+    , local{}
+    , rng{id + 1}
+    {}
+
+    job_queue* owner;
+    ws_deque<inplace_task*> local;
+    std::minstd_rand rng;
+  };
+
 public:
-  constexpr explicit job_queue()
+  constexpr explicit job_queue(const pool_config& cfg = {})
   : mu{}
   , wmtx{}
   , num_tasks{0}
   , scheduler{}
-  , task_qs{create_taskqs_tuple(std::make_index_sequence<NumQs>{})}
+  , task_qs{}
   , all_qs{}
+  , weights(NumQs, 1u)
+  , weights_gen{0}
+  , worker_load{1}
   , tasks{}
   , cur_output{&tasks[0]}
   , old_output{&tasks[1]}
+  , ready_tasks{0}
+  , staged_tasks{0}
+  , exec_ns{0}
+  , exec_n{0}
+  , wait_ns{0}
+  , wait_n{0}
+  , batch_ts{}
+  , published{}
+  , config{cfg}
+  , workers{}
+  , next_worker{0}
+  , local_tasks{0}
+  , sleepers{0}
+  , parking{}
+  , timers{}
   {
     create_taskqs_array(task_qs, std::make_index_sequence<NumQs>{});
+    scheduler.install(all_qs);
+    if (config.dispatch != dispatch_mode::eShared) {
+      workers.reserve(config.max_threads);
+      for (unsigned i = 0; i < std::max(1u, config.max_threads); ++i)
+        workers.emplace_back(std::make_unique<worker_state>(this, i));
+    }
   }
 
-  template <typename C>
+  job_queue(const job_queue&) = delete;
+  job_queue& operator = (const job_queue&) = delete;
+
+  ~job_queue() {
+    for (auto& w : workers)
+      while (auto t = w->local.pop()) memory::pool_delete(t);
+  }
+
+  template <template<typename> class Future = std::future, typename C>
   constexpr decltype(auto) schedule_task(C&& t) {
-    auto futs = collect_future(std::forward<C>(t));
-    auto n = insert_task(std::forward<C>(t));
-    {
-      std::lock_guard l(mu);
-      num_tasks += n;
+    auto futs = collect_future<Future>(std::forward<C>(t));
+    if constexpr (traits::is_time_task_v<typename traits::FindTaskType<C>::type>) {
+      defer_until_due(std::forward<C>(t));
+      return futs;
     }
-    sched_cond.notify_one();
+    else if constexpr (std::is_void_v<typename traits::FindTaskType<C>::type::PriorityType>) {
+      using T = std::remove_cvref_t<C>;
+      if constexpr (traits::is_vector<T>::value) {
+        // tasks spawned by a worker stay on its own deque
+        if (auto w = local_worker()) {
+          for (auto&& x : t) push_local(*w, to_inplace_task(std::move(x)), false);
+          notify_local(t.size());
+          return futs;
+        }
+      }
+      else {
+        submit(to_inplace_task(std::forward<C>(t)));
+        return futs;
+      }
+    }
+    add_pending(insert_task(std::forward<C>(t)));
     return futs;
   }
 
+  // FIFO task, result (if any) is plumbed by the callable itself
+  void submit(inplace_task&& t) {
+    if (auto w = local_worker()) return push_local(*w, std::move(t));
+    if (try_direct_dispatch(t)) return;
+    add_pending(fifo_queue().put(std::move(t)));
+  }
+
+  // FIFO tasks make(*it) for each element, single scheduler wake up for all
+  template <std::input_iterator I, std::sentinel_for<I> S, typename Make>
+  void submit_bulk(I first, S last, Make&& make) {
+    std::size_t n = 0;
+    if (auto w = local_worker()) {
+      for (; first != last; ++first, ++n) push_local(*w, make(*first), false);
+      return notify_local(n);
+    }
+    // parked workers first, rest goes to queue
+    for (; first != last && config.direct_dispatch && parking.idle_count() > 0; ++first) {
+      auto t = make(*first);
+      if (!try_direct_dispatch(t)) {
+        n += fifo_queue().put(std::move(t));
+        ++first;
+        break;
+      }
+    }
+    for (; first != last; ++first) n += fifo_queue().put(make(*first));
+    if (n > 0) add_pending(n);
+  }
+
+  // scheduling weight of queue holding Prio tasks, see fairshare_algo
+  template <typename Prio>
+  void set_weight(unsigned w) {
+    constexpr auto i = compile_time::find<typename TaskQueueFor<Prio>::type, TaskQueueTupleType>();
+    static_assert(i < NumQs, "priority type not registered");
+    std::lock_guard l(mu);
+    weights[i] = std::max(1u, w);
+    weights_gen.fetch_add(1, std::memory_order::release);
+  }
+
+  deadline_taskq& deadline_queue() {
+    return std::get<typename TaskQueueFor<deadline>::type>(task_qs);
+  }
+
+  const deadline_taskq& deadline_queue() const {
+    return std::get<typename TaskQueueFor<deadline>::type>(task_qs);
+  }
+
+  // takes effect on next scheduler tick, workers keep running
+  void set_algorithm(sched_algos::names n) {
+    scheduler.update_algorithm(n);
+    sched_cond.notify_one();
+  }
+
+  sched_algos::names algorithm() const { return scheduler.algorithm(); }
+
+  // measurements and batch sizing of the last scheduler tick
+  sched_stats scheduler_stats() const {
+    std::lock_guard l(mu);
+    return published;
+  }
+
+  timer_service& timer() { return timers; }
+
+  // timer thread, releases time tasks and timed posts when due
+  void timer_fn(managed_stop_token st) {
+    timers.run(std::move(st));
+  }
+
   void close() {}
   void stop() {}
 
@@ -99,43 +233,71 @@ public:
   }
 #endif
   void schedule_fn(managed_stop_token st) {
-    statistics stats{std::chrono::system_clock::now(), {{all_qs, num_tasks, -1}, {cur_output, 0}}, {16, 16} };
-    unsigned pending_tasks = 0u;
+    if (config.dispatch == dispatch_mode::eDecentralized)
+      return rebalance_fn(std::move(st));
+    const auto nw = std::max(1u, config.max_threads);
+    statistics stats{std::chrono::system_clock::now(), {{all_qs, 0u, -1, weights}, {old_output, 0}}, {nw, nw}, {}};
     for(;;) {
-      thread_local bool ne = false;
+      bool ne = false;
       stats.jobq.out.reset();
       stats.jobq.out.cur_output = old_output;
       {
         std::unique_lock l(mu);
-        ne = sched_cond.wait(l, st, [&] {
-              if (num_tasks > 0) {
-                scheduler.apply(stats);
-                num_tasks -= stats.jobq.out.new_tasks;
-              }
-              return !old_output->empty();
-             });
+        sched_cond.wait(l, st, [&] { return num_tasks > 0 || !old_output->empty(); });
         if (st.stop_requested()) [[unlikely]] break;
-#if 0
-        else if (st.pause_requested()) [[unlikely]] {
-          l.unlock();
-          st.pause();
-          l.lock();
+
+        sample(stats);
+        scheduler.compute_stats(stats);
+        published = stats.sched;
+        deadline_queue().set_run_estimate(stats.sched.exec_time);
+        // nobody idle, give submitters a moment to fill the batch
+        if (old_output->empty() && num_tasks < stats.sched.batch && stats.sched.linger.count() > 0)
+          sched_cond.wait_for(l, st, stats.sched.linger, [&] { return num_tasks >= stats.sched.batch; });
+
+        if (num_tasks > 0) {
+          stats.ts = std::chrono::system_clock::now();
+          scheduler.apply(stats);
+          // dropped tasks (see deadline_policy) never show up in output
+          if (0u == stats.jobq.out.new_tasks) num_tasks = queued();
+          else num_tasks -= std::min<std::size_t>(num_tasks, stats.jobq.out.new_tasks);
         }
-#endif
+        ne = !old_output->empty();
+        staged_tasks.store(old_output->size());
       }
       if (ne) {
         {
           std::unique_lock l(wmtx);
           sched_cond.wait(l, st, [&] { return cur_output->empty(); });
           std::swap(cur_output, old_output);
-          //idx = 0;
-          //old_output->clear();
           stats.jobq.out.new_tasks = cur_output->size();
+          ready_tasks.store(stats.jobq.out.new_tasks);
+          staged_tasks.store(0);
+          batch_ts = std::chrono::steady_clock::now();
         }
-        util::notify_cv(cond_full, stats.jobq.out.new_tasks);
+        wake_idle(stats.jobq.out.new_tasks);
       }
+    }
+  }
 
-    //std::cerr << std::this_thread::get_id() << " schedule_fn: " << pending_tasks << ", " << stats.jobq.out.new_tasks << ", " << ne << ", " << old_output->size() << std::endl;
+  // eDecentralized: workers schedule themselves, this only refreshes batch
+  // size from live statistics and wakes workers for work nobody picked up
+  void rebalance_fn(managed_stop_token st) {
+    const auto nw = std::max(1u, config.max_threads);
+    statistics stats{std::chrono::system_clock::now(), {{all_qs, 0u, -1, weights}, {old_output, 0}}, {nw, nw}, {}};
+    while (!st.stop_requested()) {
+      {
+        std::unique_lock l(mu);
+        sched_cond.wait_for(l, st, Static::rebalance_period(), [] { return false; });
+        if (st.stop_requested()) [[unlikely]] break;
+        sample(stats);
+        stats.jobq.in.num_tasks = queued();
+        scheduler.compute_stats(stats);
+        published = stats.sched;
+        deadline_queue().set_run_estimate(stats.sched.exec_time);
+      }
+      worker_load.store(stats.jobq.in.load_factor, std::memory_order::relaxed);
+      if (stats.jobq.in.num_tasks > 0 && parking.idle_count() > 0)
+        parking.wake(stats.jobq.in.num_tasks);
     }
   }
 
@@ -159,17 +321,30 @@ public:
         {
           //std::cerr << std::this_thread::get_id() << " work[" << i << "] " << n << "\n";
         }
-        cur_output->at(i)->execute();
+        (*cur_output)[i]();
       }
       std::atomic_fetch_sub_explicit(&idx, 1, std::memory_order::acq_rel);
     }
   }
 
   void worker_fn(managed_stop_token st) {
+    struct scope {
+      explicit scope(job_queue* q) { this_pool = q; }
+      ~scope() { this_pool = nullptr; }
+    } on_worker(this);
+
+    if (config.dispatch == dispatch_mode::eDecentralized)
+      return self_sched_worker_fn(std::move(st));
+    if (config.dispatch == dispatch_mode::eWorkStealing)
+      return steal_worker_fn(std::move(st));
+    if (parks_idle())
+      return park_worker_fn(std::move(st));
+
     for(;;) {
-      thread_local std::unique_ptr<executable> t{nullptr};
+      inplace_task t;
       {
         std::unique_lock l(wmtx);
+        sleepers.fetch_add(1);
         cond_full.wait(l, st, [&] {
           if (cur_output->empty()) {
             sched_cond.notify_one();
@@ -178,6 +353,7 @@ public:
           else 
             return true;
         });
+        sleepers.fetch_sub(1);
         if (st.stop_requested()) [[unlikely]] break;
 #if 0
         else if (st.pause_requested()) [[unlikely]] {
@@ -187,29 +363,176 @@ public:
           continue;
         }
 #endif
-        t = std::move(cur_output->front());
-        cur_output->pop_front();
+        t = pop_output();
       }
 
-      t->execute();
+      run(t);
     }
   }
 
-  template <typename C>
+  // calling thread is a worker of this pool
+  bool is_worker() const { return this_pool == this; }
+
+  // runs one task for a pool worker waiting on a result: own deque first,
+  // then other workers' deques, then scheduler output. False when caller
+  // isn't a worker of this pool or nothing was ready. Decentralized workers
+  // don't schedule from priority queues here, their nested tasks are on
+  // local deques anyway.
+  bool help_one() {
+    if (!is_worker()) return false;
+    inplace_task t;
+    if (auto w = local_worker()) {
+      t = next_task(*w);
+    }
+    else {
+      std::lock_guard l(wmtx);
+      t = pop_output();
+    }
+    if (!t) return false;
+    run(t);
+    return true;
+  }
+
+  void steal_worker_fn(managed_stop_token st) {
+    auto& me = *workers[next_worker.fetch_add(1, std::memory_order::relaxed) % workers.size()];
+    this_worker = &me;
+    if (parks_idle()) {
+      parking_lot::slot s;
+      std::stop_callback wake_on_stop(st, [&] { parking.wake(s); });
+      while (!st.stop_requested()) {
+        auto t = next_task(me);
+        if (!t) t = idle_wait(s, st, [&] { return local_tasks.load() > 0 || ready_tasks.load() > 0; });
+        if (t) run(t);
+      }
+      if (auto t = parking.leave(s)) t();
+      this_worker = nullptr;
+      return;
+    }
+
+    for(;;) {
+      if (st.stop_requested()) [[unlikely]] break;
+
+      if (auto t = next_task(me)) {
+        run(t);
+        continue;
+      }
+
+      std::unique_lock l(wmtx);
+      sleepers.fetch_add(1);
+      cond_full.wait(l, st, [&] {
+        if (local_tasks.load() > 0) return true;
+        if (cur_output->empty()) {
+          sched_cond.notify_one();
+          return false;
+        }
+        return true;
+      });
+      sleepers.fetch_sub(1);
+    }
+    this_worker = nullptr;
+  }
+
+  // own deque, steal, then batch from task queues picked by schedule_algo
+  void self_sched_worker_fn(managed_stop_token st) {
+    auto& me = *workers[next_worker.fetch_add(1, std::memory_order::relaxed) % workers.size()];
+    this_worker = &me;
+    const auto nw = std::max(1u, config.max_threads);
+    std::vector<unsigned> my_weights;
+    unsigned my_gen = ~0u;
+    task_buffer batch;
+    statistics stats{std::chrono::system_clock::now(), {{all_qs, 0u, 1, my_weights}, {&batch, 0}}, {nw, nw}, {}};
+    const auto tid = std::this_thread::get_id();
+
+    parking_lot::slot s;
+    std::stop_callback wake_on_stop(st, [&] { parking.wake(s); });
+    while (!st.stop_requested()) {
+      auto t = take_local(me);
+      if (!t) {
+        if (auto g = weights_gen.load(std::memory_order::acquire); g != my_gen) {
+          std::lock_guard l(mu);
+          my_weights = weights;
+          my_gen = g;
+        }
+        t = self_schedule(me, stats, tid);
+      }
+      if (!t) t = idle_wait(s, st, [&] { return local_tasks.load() > 0 || queued() > 0; });
+      if (t) run(t);
+    }
+    if (auto t = parking.leave(s)) t();
+    this_worker = nullptr;
+  }
+
+  // first task of the batch is returned, rest goes on own deque for thieves
+  inplace_task self_schedule(worker_state& me, statistics& stats, std::thread::id tid) {
+    auto& out = *stats.jobq.out.cur_output;
+    stats.jobq.in.load_factor = worker_load.load(std::memory_order::relaxed);
+    stats.jobq.out.reset();
+    if (scheduler.reschedule_worker(stats, tid) <= 0 || out.empty()) return {};
+
+    inplace_task t = std::move(out.front());
+    out.pop_front();
+    const auto k = out.size();
+    for (; !out.empty(); out.pop_front())
+      me.local.push(memory::pool_new<inplace_task>(std::move(out.front())));
+    if (k > 0) {
+      local_tasks.fetch_add(k);
+      notify_local(k);
+    }
+    return t;
+  }
+
+  // like worker_fn, but waits per config.wait on its own parking slot,
+  // producers can hand over tasks to it directly
+  void park_worker_fn(managed_stop_token st) {
+    parking_lot::slot me;
+    std::stop_callback wake_on_stop(st, [&] { parking.wake(me); });
+    while (!st.stop_requested()) {
+      inplace_task t;
+      {
+        std::lock_guard l(wmtx);
+        t = pop_output();
+      }
+      if (!t) t = idle_wait(me, st, [&] { return ready_tasks.load() > 0; });
+      if (t) run(t);
+    }
+    if (auto t = parking.leave(me)) t();
+  }
+
+  // spin and/or park till has_work(), returns task handed over by direct
+  // dispatch, if any
+  template <typename Pred>
+  inplace_task idle_wait(parking_lot::slot& s, const managed_stop_token& st, Pred&& has_work) {
+    if (config.wait == wait_strategy::eBusyPoll) {
+      while (!has_work() && !st.stop_requested()) platform::cpu_relax();
+      return {};
+    }
+    if (config.wait == wait_strategy::eSpinPark) {
+      for (unsigned i = 0; i < Static::spin_before_park(); ++i) {
+        if (has_work()) return {};
+        platform::cpu_relax();
+      }
+    }
+    parking.enlist(s);
+    if (has_work() || st.stop_requested()) return parking.leave(s);
+    return parking.park(s);
+  }
+
+  // Future: std::future or thp::future
+  template <template<typename> class Future = std::future, typename C>
   constexpr decltype(auto) collect_future(C&& t)
   {
     using T = std::remove_cvref_t<decltype(t)>;
 
-    if      constexpr (traits::is_unique_ptr<T>::value)            { return t->future(); }
-    else if constexpr (traits::is_shared_ptr<T>::value)            { return t->future(); }
-    else if constexpr (traits::is_reference_wrapper<T>::value)     { return t.get().future(); }
-    else if constexpr (std::is_base_of_v<executable, T>)           { return t.future(); }
+    if      constexpr (traits::is_unique_ptr<T>::value)            { return future_of<Future>(*t); }
+    else if constexpr (traits::is_shared_ptr<T>::value)            { return future_of<Future>(*t); }
+    else if constexpr (traits::is_reference_wrapper<T>::value)     { return future_of<Future>(t.get()); }
+    else if constexpr (std::is_base_of_v<executable, T>)           { return future_of<Future>(t); }
     else if constexpr (traits::is_vector<T>::value || traits::is_linked_list<T>::value) {
       using TaskType = traits::FindTaskType<std::remove_cvref_t<typename T::value_type>>::type;
       using ReturnType = typename TaskType::ReturnType;
-      std::deque<std::future<ReturnType>> futs;
+      std::deque<Future<ReturnType>> futs;
       std::ranges::transform(t, std::back_inserter(futs),
-                             [&](auto&& x) { return collect_future(x); });
+                             [&](auto&& x) { return collect_future<Future>(x); });
       return futs;
     }
     else {
@@ -221,10 +544,223 @@ public:
     return num_tasks;
   }
 
+  template <template<typename> class Future, typename Task>
+  static constexpr decltype(auto) future_of(Task& t) {
+    if constexpr (traits::is_thp_future_v<Future>) return t.lite_future();
+    else                                           return t.future();
+  }
+
 protected:
 
   //friend class scheduler;
 
+  worker_state* local_worker() const {
+    return (this_worker && this_worker->owner == this) ? this_worker : nullptr;
+  }
+
+  void add_pending(std::size_t n) {
+    // workers pick tasks up themselves
+    if (config.dispatch == dispatch_mode::eDecentralized) {
+      parking.wake(n);
+      return;
+    }
+    {
+      std::lock_guard l(mu);
+      num_tasks += n;
+    }
+    sched_cond.notify_one();
+  }
+
+  void push_local(worker_state& w, inplace_task&& t, bool notify = true) {
+    w.local.push(memory::pool_new<inplace_task>(std::move(t)));
+    local_tasks.fetch_add(1);
+    if (notify) notify_local(1);
+  }
+
+  bool parks_idle() const {
+    return config.wait != wait_strategy::eCondVar || config.direct_dispatch
+           || config.dispatch == dispatch_mode::eDecentralized;
+  }
+
+  // wake up to n idle workers, scheduler output swap
+  void wake_idle(std::size_t n) {
+    if (parks_idle()) parking.wake(n);
+    else              util::notify_cv(cond_full, n);
+  }
+
+  // wake up to n idle workers, tasks pushed on a local deque
+  void notify_local(std::size_t n) {
+    if (parks_idle()) {
+      parking.wake(n);
+      return;
+    }
+    if (n > 0 && sleepers.load() > 0) {
+      std::lock_guard l(wmtx);
+      util::notify_cv(cond_full, n);
+    }
+  }
+
+  static inplace_task take_pooled(inplace_task* p) {
+    inplace_task t = std::move(*p);
+    memory::pool_delete(p);
+    return t;
+  }
+
+  // false leaves task untouched
+  bool try_direct_dispatch(inplace_task& t) {
+    if (!config.direct_dispatch || 0u == parking.idle_count()) return false;
+    // don't overtake tasks queued, staged by scheduler, in its output or on
+    // worker deques
+    if (ready_tasks.load() > 0 || staged_tasks.load() > 0 || local_tasks.load() > 0) return false;
+    if (!std::ranges::all_of(all_qs, &task_queue::empty)) return false;
+    return parking.handoff(t);
+  }
+
+  // own deque, then random victims, then a batch from scheduler output
+  inplace_task next_task(worker_state& me) {
+    if (auto t = take_local(me)) return t;
+    return take_output(me);
+  }
+
+  // own deque, then random victims
+  inplace_task take_local(worker_state& me) {
+    if (auto t = me.local.pop()) {
+      local_tasks.fetch_sub(1);
+      return take_pooled(t);
+    }
+
+    const auto nw = workers.size();
+    for (std::size_t i = 0; i < nw && local_tasks.load(std::memory_order::relaxed) > 0; ++i) {
+      auto& victim = *workers[me.rng() % nw];
+      if (&victim == &me) continue;
+      if (auto t = victim.local.steal()) {
+        local_tasks.fetch_sub(1);
+        return take_pooled(t);
+      }
+    }
+    return {};
+  }
+
+  // a worker's share of scheduler output, one to run, rest on own deque
+  inplace_task take_output(worker_state& me) {
+    const auto nw = workers.size();
+    inplace_task t;
+    std::size_t k = 0;
+    {
+      std::lock_guard l(wmtx);
+      if (cur_output->empty()) {
+        sched_cond.notify_one();
+        return {};
+      }
+      k = std::max<std::size_t>(1u, cur_output->size() / nw) - 1;
+      t = pop_output();
+      for (auto i = k; i > 0; --i)
+        me.local.push(memory::pool_new<inplace_task>(pop_output()));
+      if (k > 0) local_tasks.fetch_add(k);
+    }
+    notify_local(k);
+    return t;
+  }
+
+  // caller holds wmtx
+  inplace_task pop_output() {
+    inplace_task t;
+    if (!cur_output->empty()) {
+      t = std::move(cur_output->front());
+      cur_output->pop_front();
+      ready_tasks.store(cur_output->size());
+      if (cur_output->empty()) {
+        // batch drained, its tasks waited half of that on average
+        const auto drain = std::chrono::steady_clock::now() - batch_ts;
+        wait_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(drain).count() / 2, std::memory_order::relaxed);
+        wait_n.fetch_add(1, std::memory_order::relaxed);
+      }
+    }
+    if (cur_output->empty()) sched_cond.notify_one();
+    return t;
+  }
+
+  // every Static::exec_sample_period()-th task of a worker is timed
+  void run(inplace_task& t) {
+    thread_local unsigned n = 0;
+    if (++n % Static::exec_sample_period() != 0) return t();
+    const auto start = std::chrono::steady_clock::now();
+    t();
+    const auto d = std::chrono::steady_clock::now() - start;
+    exec_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(), std::memory_order::relaxed);
+    exec_n.fetch_add(1, std::memory_order::relaxed);
+  }
+
+  // caller holds mu, drains samples gathered since previous tick
+  void sample(statistics& stats) {
+    using std::chrono::nanoseconds;
+    auto mean = [](std::atomic<std::uint64_t>& sum, std::atomic<std::uint64_t>& n) {
+      const auto k = n.exchange(0, std::memory_order::relaxed);
+      const auto s = sum.exchange(0, std::memory_order::relaxed);
+      return k ? nanoseconds(s / k) : nanoseconds(0);
+    };
+    auto& s = stats.sched;
+    s.exec_sample = mean(exec_ns, exec_n);
+    s.wait_sample = mean(wait_ns, wait_n);
+    s.idle_workers = parks_idle() ? parking.idle_count() : sleepers.load();
+    stats.jobq.in.num_tasks = num_tasks;
+  }
+
+  std::size_t queued() const {
+    std::size_t n = 0;
+    for (auto q : all_qs) n += q->len();
+    return n;
+  }
+
+  // time task goes to timer service, its priority queue only once it is due
+  template <typename C>
+  void defer_until_due(C&& t) {
+    using T = std::remove_cvref_t<C>;
+    if constexpr (traits::is_vector<T>::value) {
+      for (auto&& x : t) defer_until_due(std::move(x));
+    }
+    else if constexpr (traits::is_time_series_task_v<typename traits::FindTaskType<C>::type>) {
+      using S = typename traits::FindTaskType<C>::type;
+      if constexpr (traits::is_unique_ptr<T>::value) arm_series(std::shared_ptr<S>(std::move(t)));
+      else                                           arm_series(std::make_shared<S>(std::move(t)));
+    }
+    else {
+      timer_service::clock::time_point due;
+      if constexpr (traits::is_unique_ptr<T>::value) due = to_steady(t->start_time());
+      else                                           due = to_steady(t.start_time());
+
+      if (due <= timer_service::clock::now()) {
+        add_pending(insert_task(std::move(t)));
+        return;
+      }
+      timers.schedule_at(due, [this, x = std::move(t)] () mutable {
+        add_pending(insert_task(std::move(x)));
+      });
+    }
+  }
+
+  // one point of series per worker task, next point is armed after it ran,
+  // so series holds no worker while waiting and its runs never overlap
+  template <typename S>
+  void arm_series(std::shared_ptr<S> s) {
+    if (!s->pending()) return;
+    timers.schedule_at(to_steady(s->next_time()), [this, s] {
+      submit(inplace_task([this, s] {
+        s->run_next();
+        arm_series(s);
+      }));
+    });
+  }
+
+  template <typename TimePoint>
+  static timer_service::clock::time_point to_steady(const TimePoint& tp) {
+    using Clock = typename TimePoint::clock;
+    if constexpr (std::is_same_v<Clock, timer_service::clock>)
+      return std::chrono::time_point_cast<timer_service::clock::duration>(tp);
+    else
+      return timer_service::clock::now() + std::chrono::duration_cast<timer_service::clock::duration>(tp - Clock::now());
+  }
+
   template <typename C>
   constexpr std::size_t insert_task(C&& t) {
     using TaskType = traits::FindTaskType<C>::type;
@@ -238,14 +774,13 @@ protected:
     ((all_qs.emplace_back(std::addressof(std::get<I>(std::forward<Tuple>(tup))))), ...);
   }
 
-  template<std::size_t...I>
-  constexpr TaskQueueTupleType create_taskqs_tuple(std::index_sequence<I...>) {
-    return std::make_tuple(std::tuple_element_t<I, TaskQueueTupleType>()...);
+  constexpr inline auto& fifo_queue(void) {
+    return std::get<typename TaskQueueFor<void>::type>(task_qs);
   }
 
   template <typename TaskType>
   constexpr inline auto& taskq_for(void) {
-	  using T = priority_taskq<typename TaskType::PriorityType>;
+	  using T = typename TaskQueueFor<typename TaskType::PriorityType>::type;
     return std::get<T>(task_qs);
   }
 
@@ -258,9 +793,38 @@ private:
   // task queues for different task types
   TaskQueueTupleType task_qs;
   std::vector<task_queue*> all_qs;
-  std::deque<std::unique_ptr<executable>> tasks[2], *cur_output, *old_output;
+  // guarded by mu, read by scheduler algos through statistics
+  std::vector<unsigned> weights;
+  // bumped on weights change, self scheduling workers keep a copy
+  std::atomic<unsigned> weights_gen;
+  // load factor for self scheduling workers, set by rebalance_fn
+  std::atomic<int> worker_load;
+  task_buffer tasks[2], *cur_output, *old_output;
+  // cur_output->size(), for lock free idle checks
+  std::atomic<std::size_t> ready_tasks;
+  // old_output->size() between scheduler tick and swap, see try_direct_dispatch
+  std::atomic<std::size_t> staged_tasks;
+  // adaptive batching samples, see task_scheduler::compute_stats
+  std::atomic<std::uint64_t> exec_ns, exec_n, wait_ns, wait_n;
+  // guarded by wmtx
+  std::chrono::steady_clock::time_point batch_ts;
+  // guarded by mu
+  sched_stats published;
   std::condition_variable_any cond_empty, cond_full, cond_stop, sched_cond;
   bool closed, stopped;
+  // work stealing
+  pool_config config;
+  std::vector<std::unique_ptr<worker_state>> workers;
+  std::atomic<unsigned> next_worker;
+  std::atomic<std::int64_t> local_tasks;
+  std::atomic<unsigned> sleepers;
+  // direct dispatch and non condvar wait strategies
+  parking_lot parking;
+  // time tasks and timed posts which aren't due yet
+  timer_service timers;
+  static inline thread_local worker_state* this_worker = nullptr;
+  // any dispatch mode, for help_one()
+  static inline thread_local job_queue* this_pool = nullptr;
 };
 
 } // namespace thp
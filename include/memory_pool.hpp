@@ -0,0 +1,210 @@
+#ifndef MEMORY_POOL_HPP_
+#define MEMORY_POOL_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <utility>
+
+namespace thp {
+namespace memory {
+
+//
+// fixed size block pool: per thread cache of free blocks on top of a shared
+// list of free batches. Steady state allocate/deallocate touch only thread
+// local cache, blocks migrate between threads a batch at a time and an
+// exiting thread hands its whole cache back.
+// Chunks are carved 64 byte aligned and never returned to the system.
+//
+template <std::size_t BlockSize>
+class block_pool {
+  static_assert(BlockSize >= sizeof(void*) && BlockSize % 64 == 0, "block size must be multiple of 64");
+
+  struct node { node* next; };
+  static constexpr std::size_t batch = 64;
+
+  // free list of count blocks, full batches but for leftovers of exited threads
+  struct free_list {
+    node* head = nullptr;
+    std::size_t count = 0;
+  };
+
+  struct central_list {
+    std::mutex mu;
+    std::vector<free_list> batches;
+  };
+
+  // hands all its blocks to the central list when thread exits
+  struct local_cache : free_list {
+    ~local_cache() {
+      flush(*this);
+      gone() = true;
+    }
+  };
+
+  static central_list& central() {
+    // leaked deliberately, thread caches may outlive static destruction
+    static central_list* c = new central_list;
+    return *c;
+  }
+
+  static local_cache& local() {
+    thread_local local_cache c;
+    return c;
+  }
+
+  // set once this thread's cache is destroyed, other thread_local
+  // destructors running later go straight to the central list
+  static bool& gone() {
+    thread_local bool g = false;
+    return g;
+  }
+
+  static void refill(free_list& c) {
+    auto& cl = central();
+    {
+      std::lock_guard l(cl.mu);
+      if (!cl.batches.empty()) {
+        c = cl.batches.back();
+        cl.batches.pop_back();
+        return;
+      }
+    }
+    auto chunk = static_cast<std::byte*>(::operator new(BlockSize*batch, std::align_val_t{64}));
+    for (std::size_t i = 0; i < batch; ++i) {
+      auto n = reinterpret_cast<node*>(chunk + i*BlockSize);
+      n->next = c.head;
+      c.head = n;
+    }
+    c.count = batch;
+  }
+
+  // moves first k blocks of c to the central list
+  static void release(free_list& c, std::size_t k) {
+    auto head = c.head;
+    auto tail = head;
+    for (std::size_t i = 1; i < k; ++i) tail = tail->next;
+    c.head = tail->next;
+    tail->next = nullptr;
+    c.count -= k;
+
+    auto& cl = central();
+    std::lock_guard l(cl.mu);
+    cl.batches.push_back({head, k});
+  }
+
+  static void flush(free_list& c) {
+    while (c.count >= batch) release(c, batch);
+    if (c.count > 0) release(c, c.count);
+  }
+
+public:
+  static constexpr std::size_t block_size = BlockSize;
+
+  static void* allocate() {
+    if (gone()) [[unlikely]] {
+      free_list c;
+      refill(c);
+      auto n = pop(c);
+      flush(c);
+      return n;
+    }
+    auto& c = local();
+    if (!c.head) [[unlikely]] refill(c);
+    return pop(c);
+  }
+
+  static void deallocate(void* p) noexcept {
+    auto n = static_cast<node*>(p);
+    if (gone()) [[unlikely]] {
+      free_list c;
+      push(c, n);
+      return flush(c);
+    }
+    auto& c = local();
+    push(c, n);
+    if (c.count >= 2*batch) [[unlikely]] release(c, batch);
+  }
+
+private:
+  static node* pop(free_list& c) {
+    auto n = c.head;
+    c.head = n->next;
+    --c.count;
+    return n;
+  }
+
+  static void push(free_list& c, node* n) {
+    n->next = c.head;
+    c.head = n;
+    ++c.count;
+  }
+};
+
+// size class dispatch, larger or over aligned requests go to operator new
+inline void* allocate_bytes(std::size_t bytes, std::size_t align) {
+  if (align <= 64) {
+    if (bytes <= 64)  return block_pool<64>::allocate();
+    if (bytes <= 128) return block_pool<128>::allocate();
+    if (bytes <= 256) return block_pool<256>::allocate();
+    if (bytes <= 512) return block_pool<512>::allocate();
+  }
+  return ::operator new(bytes, std::align_val_t{align});
+}
+
+inline void deallocate_bytes(void* p, std::size_t bytes, std::size_t align) noexcept {
+  if (align <= 64) {
+    if (bytes <= 64)  return block_pool<64>::deallocate(p);
+    if (bytes <= 128) return block_pool<128>::deallocate(p);
+    if (bytes <= 256) return block_pool<256>::deallocate(p);
+    if (bytes <= 512) return block_pool<512>::deallocate(p);
+  }
+  ::operator delete(p, std::align_val_t{align});
+}
+
+// std allocator interface over pools, e.g. for std::promise shared state
+template <typename T>
+struct pool_allocator {
+  using value_type = T;
+
+  constexpr pool_allocator() noexcept = default;
+  template <typename U>
+  constexpr pool_allocator(const pool_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(allocate_bytes(n*sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    deallocate_bytes(p, n*sizeof(T), alignof(T));
+  }
+
+  template <typename U>
+  friend constexpr bool operator == (const pool_allocator&, const pool_allocator<U>&) noexcept { return true; }
+};
+
+template <typename T, typename... Args>
+T* pool_new(Args&&... args) {
+  auto p = allocate_bytes(sizeof(T), alignof(T));
+  try {
+    return ::new (p) T(std::forward<Args>(args)...);
+  }
+  catch(...) {
+    deallocate_bytes(p, sizeof(T), alignof(T));
+    throw;
+  }
+}
+
+template <typename T>
+void pool_delete(T* p) noexcept {
+  if (!p) return;
+  p->~T();
+  deallocate_bytes(p, sizeof(T), alignof(T));
+}
+
+} // namespace memory
+} // namespace thp
+
+#endif // MEMORY_POOL_HPP_
@@ -0,0 +1,176 @@
+#ifndef MPMC_TASKQ_HPP_
+#define MPMC_TASKQ_HPP_
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "include/configuration.hpp"
+#include "include/task_buffer.hpp"
+#include "include/task_queue.hpp"
+#include "include/traits.hpp"
+
+namespace thp {
+
+//
+// bounded lock free multi producer multi consumer FIFO task queue
+// (Dmitry Vyukov's sequence numbered ring buffer)
+//
+// capacity is rounded up to power of 2. When ring is full, producers spill
+// into a mutex guarded overflow buffer instead of blocking, so a worker
+// submitting into a full queue can't deadlock the pool. While overflow is
+// not empty producers keep appending to it, and a consumer finding the ring
+// empty moves the oldest overflow tasks back into the ring. Spilled tasks
+// so keep their place in line, only producers racing the spill itself may
+// get ahead of it.
+//
+class mpmc_taskq : public task_queue {
+  struct cell {
+    std::atomic<std::size_t> seq;
+    inplace_task data;
+  };
+
+public:
+  explicit mpmc_taskq(std::size_t capacity = Static::per_queue_capacity())
+  : mask{std::bit_ceil(std::max<std::size_t>(capacity, 2u)) - 1}
+  , cells{new cell[mask + 1]}
+  , enq_pos{0}
+  , deq_pos{0}
+  , overflow_mu{}
+  , overflow{}
+  , overflow_len{0}
+  {
+    for (std::size_t i = 0; i <= mask; ++i)
+      cells[i].seq.store(i, std::memory_order::relaxed);
+  }
+
+  mpmc_taskq(const mpmc_taskq&) = delete;
+  mpmc_taskq& operator = (const mpmc_taskq&) = delete;
+
+  std::size_t pop(inplace_task& t) override {
+    return (try_pop(t) || pop_overflow(t)) ? 1 : 0;
+  }
+
+  std::size_t pop_n(task_buffer& out, std::size_t n) override {
+    std::size_t k = 0;
+    inplace_task t;
+    while (k < n && (try_pop(t) || pop_overflow(t))) {
+      out.push_back(std::move(t));
+      ++k;
+    }
+    return k;
+  }
+
+  template<typename... C>
+  constexpr std::size_t put(C&&... c) {
+    std::size_t ret = 0;
+    ((ret += _insert(std::forward<C>(c))), ...);
+    return ret;
+  }
+
+  // relaxed snapshot, may be stale by the time caller looks at it
+  std::size_t len() const override {
+    auto e = enq_pos.load(std::memory_order::relaxed);
+    auto d = deq_pos.load(std::memory_order::relaxed);
+    return (e > d ? e - d : 0u) + overflow_len.load(std::memory_order::relaxed);
+  }
+
+  std::size_t capacity() const { return mask + 1; }
+
+  bool try_push(inplace_task& p) {
+    auto pos = enq_pos.load(std::memory_order::relaxed);
+    for (;;) {
+      auto& c = cells[pos & mask];
+      auto seq = c.seq.load(std::memory_order::acquire);
+      auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (dif == 0) {
+        if (enq_pos.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+          c.data = std::move(p);
+          c.seq.store(pos + 1, std::memory_order::release);
+          return true;
+        }
+      }
+      else if (dif < 0) {
+        return false; // full
+      }
+      else {
+        pos = enq_pos.load(std::memory_order::relaxed);
+      }
+    }
+  }
+
+  bool try_pop(inplace_task& p) {
+    auto pos = deq_pos.load(std::memory_order::relaxed);
+    for (;;) {
+      auto& c = cells[pos & mask];
+      auto seq = c.seq.load(std::memory_order::acquire);
+      auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (dif == 0) {
+        if (deq_pos.compare_exchange_weak(pos, pos + 1, std::memory_order::relaxed)) {
+          p = std::move(c.data);
+          c.seq.store(pos + mask + 1, std::memory_order::release);
+          return true;
+        }
+      }
+      else if (dif < 0) {
+        return false; // empty
+      }
+      else {
+        pos = deq_pos.load(std::memory_order::relaxed);
+      }
+    }
+  }
+
+  virtual ~mpmc_taskq() = default;
+
+protected:
+  template <typename C>
+  std::size_t _insert(C&& t) {
+    using T = std::remove_cvref_t<C>;
+    if constexpr (traits::is_vector<T>::value) {
+      for (auto&& x : t) push(to_inplace_task(std::move(x)));
+      return t.size();
+    }
+    else {
+      push(to_inplace_task(std::forward<C>(t)));
+      return 1;
+    }
+  }
+
+  void push(inplace_task&& p) {
+    if (0u == overflow_len.load(std::memory_order::acquire) && try_push(p)) [[likely]] return;
+    std::lock_guard l(overflow_mu);
+    overflow.push_back(std::move(p));
+    overflow_len.fetch_add(1, std::memory_order::release);
+  }
+
+  // ring is empty: oldest spilled task to caller, following ones back into
+  // the ring as far as they fit
+  bool pop_overflow(inplace_task& p) {
+    if (0u == overflow_len.load(std::memory_order::acquire)) return false;
+    std::lock_guard l(overflow_mu);
+    if (overflow.empty()) return false;
+    p = std::move(overflow.front());
+    overflow.pop_front();
+    std::size_t k = 1;
+    for (; !overflow.empty() && try_push(overflow.front()); ++k) overflow.pop_front();
+    overflow.compact();
+    overflow_len.fetch_sub(k, std::memory_order::release);
+    return true;
+  }
+
+private:
+  const std::size_t mask;
+  std::unique_ptr<cell[]> cells;
+  alignas(64) std::atomic<std::size_t> enq_pos;
+  alignas(64) std::atomic<std::size_t> deq_pos;
+  alignas(64) std::mutex overflow_mu;
+  task_buffer overflow;
+  std::atomic<std::size_t> overflow_len;
+};
+
+} // namespace thp
+
+#endif // MPMC_TASKQ_HPP_
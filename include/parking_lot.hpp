@@ -0,0 +1,137 @@
+#ifndef PARKING_LOT_HPP_
+#define PARKING_LOT_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+#include "include/inplace_task.hpp"
+
+namespace thp {
+
+//
+// idle workers park on their own slot, a waker either hands over a task
+// through slot's mailbox or just wakes the worker up. Park/wake are futex
+// based (std::atomic::wait/notify), so exactly one worker wakes per delivery.
+//
+// Worker has to re-check for work after enlist and leave() if it finds some;
+// num_idle is seq_cst, so either the worker sees published work or the
+// producer sees the worker enlisted.
+//
+class parking_lot {
+  enum signal : unsigned { eNone = 0, eWake = 1, eTask = 2 };
+
+public:
+  struct slot {
+    std::atomic<unsigned> mailbox{eNone};
+    inplace_task task{};
+    bool listed{false};
+  };
+
+  explicit parking_lot()
+  : mu{}
+  , idle{}
+  , num_idle{0}
+  {}
+
+  parking_lot(const parking_lot&) = delete;
+  parking_lot& operator = (const parking_lot&) = delete;
+
+  // worker announces it is going to park
+  void enlist(slot& s) {
+    std::lock_guard l(mu);
+    if (s.listed) return;
+    s.listed = true;
+    idle.push_back(&s);
+    num_idle.fetch_add(1);
+  }
+
+  // blocks till something is delivered, returns task (empty on plain wake up)
+  inplace_task park(slot& s) {
+    s.mailbox.wait(eNone, std::memory_order::acquire);
+    return take(s);
+  }
+
+  // non blocking check of the mailbox
+  inplace_task take(slot& s) {
+    if (s.mailbox.exchange(eNone, std::memory_order::acq_rel) == eTask)
+      return std::move(s.task);
+    return {};
+  }
+
+  // hand task to an idle worker, false (task untouched) if none is parked
+  bool handoff(inplace_task& t) {
+    if (0u == num_idle.load()) return false;
+    std::lock_guard l(mu);
+    auto s = claim();
+    if (!s) return false;
+    s->task = std::move(t);
+    deliver(*s, eTask);
+    return true;
+  }
+
+  // wake up to n idle workers without a task
+  std::size_t wake(std::size_t n) {
+    if (n == 0u || 0u == num_idle.load()) return 0u;
+    std::lock_guard l(mu);
+    std::size_t k = 0;
+    for (; k < n; ++k) {
+      auto s = claim();
+      if (!s) break;
+      deliver(*s, eWake);
+    }
+    return k;
+  }
+
+  // wake a particular worker, e.g. on stop request
+  void wake(slot& s) {
+    std::lock_guard l(mu);
+    unsigned expected = eNone;
+    if (s.mailbox.compare_exchange_strong(expected, eWake, std::memory_order::release))
+      s.mailbox.notify_one();
+  }
+
+  // worker exits, returns undelivered task (if any) to caller
+  inplace_task leave(slot& s) {
+    {
+      std::lock_guard l(mu);
+      if (s.listed) {
+        std::erase(idle, &s);
+        s.listed = false;
+        num_idle.fetch_sub(1, std::memory_order::relaxed);
+      }
+    }
+    return take(s);
+  }
+
+  std::size_t idle_count() const { return num_idle.load(std::memory_order::relaxed); }
+
+private:
+  // caller holds mu
+  slot* claim() {
+    if (idle.empty()) return nullptr;
+    auto s = idle.back();
+    idle.pop_back();
+    s->listed = false;
+    num_idle.fetch_sub(1, std::memory_order::relaxed);
+    return s;
+  }
+
+  // caller holds mu, so slot can't leave while delivery is in flight
+  void deliver(slot& s, signal sig) {
+    [[maybe_unused]] auto old = s.mailbox.exchange(sig, std::memory_order::acq_rel);
+    // claimed slot receives exactly one delivery, at most a pending wake up
+    assert(old != eTask);
+    s.mailbox.notify_one();
+  }
+
+  std::mutex mu;
+  std::vector<slot*> idle;
+  std::atomic<std::size_t> num_idle;
+};
+
+} // namespace thp
+
+#endif // PARKING_LOT_HPP_
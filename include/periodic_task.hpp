@@ -0,0 +1,193 @@
+#ifndef PERIODIC_TASK_HPP_
+#define PERIODIC_TASK_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "include/future.hpp"
+#include "include/inplace_task.hpp"
+#include "include/sync_container.hpp"
+#include "include/timer_service.hpp"
+
+namespace thp {
+
+enum class period_mode : uint8_t
+{
+  eFixedRate = 0,   // runs on start + k*period grid, a late run doesn't shift later ones
+  eFixedDelay = 1,  // next run is period after previous one finished
+};
+
+struct periodic_config {
+  std::chrono::steady_clock::duration period;
+  period_mode mode = period_mode::eFixedRate;
+  // number of runs, 0 repeats till cancel()
+  std::size_t runs = 0;
+  // first run, default is one period from now
+  std::chrono::steady_clock::time_point start{};
+};
+
+//
+// recurring task which re-arms itself on timer service after each run, so
+// between runs it holds no worker and no thread. One run is in flight at a
+// time. Fixed rate schedule is computed from the start time, not from the
+// previous run, so it doesn't drift. When a run ends past one or more
+// following ticks, those are coalesced into a single next run and counted
+// in missed().
+//
+// Bounded series (runs > 0) stream a future per run into results(), runs
+// which didn't happen because of cancel() get broken_promise. Unbounded
+// series don't keep results, exception escaping a run goes to on_error.
+//
+template <typename Ret>
+class periodic : public std::enable_shared_from_this<periodic<Ret>> {
+public:
+  using clock = std::chrono::steady_clock;
+  using result_buffer = sync_container<thp::future<Ret>>;
+  using submit_fn = std::function<void(inplace_task&&)>;
+  using error_fn = std::function<void(std::exception_ptr)>;
+
+  periodic(const periodic_config& c, timer_service& ts, submit_fn fn, error_fn err)
+  : cfg{c}
+  , timers{ts}
+  , submit{std::move(fn)}
+  , on_error{std::move(err)}
+  , mu{}
+  , timer{}
+  , due{}
+  , cancelled{false}
+  , finished{0}
+  , nruns{0}
+  , nmissed{0}
+  , buffer{cfg.runs > 0 ? std::make_shared<result_buffer>(cfg.runs) : nullptr}
+  {
+    if (cfg.start == clock::time_point{}) cfg.start = clock::now() + cfg.period;
+  }
+
+  periodic(const periodic&) = delete;
+  periodic& operator = (const periodic&) = delete;
+
+  void start() {
+    std::lock_guard l(mu);
+    arm(cfg.start);
+  }
+
+  // no run starts after this returns, a run in progress completes
+  void cancel() {
+    cancelled.store(true);
+    std::lock_guard l(mu);
+    if (timers.cancel(timer)) finish();
+  }
+
+  // till all runs are done or series is cancelled
+  void wait() const {
+    finished.wait(0);
+  }
+
+  bool done() const               { return finished.load() != 0; }
+  std::size_t runs() const        { return nruns.load(); }
+  std::size_t missed() const      { return nmissed.load(); }
+  std::shared_ptr<result_buffer> results() const { return buffer; }
+
+  virtual ~periodic() = default;
+
+protected:
+  virtual void invoke(thp::promise<Ret>& p) = 0;
+
+private:
+  // caller holds mu
+  void arm(clock::time_point at) {
+    due = at;
+    timer = timers.schedule_at(at, [self = this->shared_from_this()] {
+      self->submit(inplace_task([self] { self->run(); }));
+    });
+  }
+
+  void run() {
+    if (cancelled.load()) return finish();
+
+    thp::promise<Ret> p;
+    auto f = p.get_future();
+    invoke(p);
+    if (buffer) buffer->put(std::move(f));
+    else        report(f);
+
+    const auto n = nruns.fetch_add(1) + 1;
+    if (cfg.runs > 0 && n >= cfg.runs) return finish();
+
+    std::lock_guard l(mu);
+    if (cancelled.load()) return finish();
+
+    const auto now = clock::now();
+    if (cfg.mode == period_mode::eFixedDelay) return arm(now + cfg.period);
+
+    // whole periods since this run was due, all but next one are skipped
+    const auto behind = static_cast<std::size_t>((now - due) / cfg.period);
+    nmissed.fetch_add(behind);
+    arm(due + static_cast<clock::rep>(behind + 1) * cfg.period);
+  }
+
+  void report(thp::future<Ret>& f) {
+    try {
+      f.get();
+    }
+    catch(...) {
+      if (on_error) on_error(std::current_exception());
+    }
+  }
+
+  void finish() {
+    if (buffer) {
+      for (auto n = nruns.load(); n < cfg.runs; ++n) {
+        thp::promise<Ret> p;
+        buffer->put(p.get_future());
+      }
+    }
+    finished.store(1);
+    finished.notify_all();
+  }
+
+  periodic_config cfg;
+  timer_service& timers;
+  submit_fn submit;
+  error_fn on_error;
+  std::mutex mu;
+  timer_id timer;
+  clock::time_point due;
+  std::atomic<bool> cancelled;
+  std::atomic<unsigned> finished;
+  std::atomic<std::size_t> nruns;
+  std::atomic<std::size_t> nmissed;
+  std::shared_ptr<result_buffer> buffer;
+};
+
+namespace details {
+
+template <typename Ret, typename Fn>
+class periodic_impl final : public periodic<Ret> {
+public:
+  using base = periodic<Ret>;
+
+  periodic_impl(const periodic_config& c, timer_service& ts, typename base::submit_fn s, typename base::error_fn e, Fn&& f)
+  : base(c, ts, std::move(s), std::move(e))
+  , fn{std::move(f)}
+  {}
+
+protected:
+  void invoke(thp::promise<Ret>& p) override {
+    p.set_from(fn);
+  }
+
+private:
+  Fn fn;
+};
+
+} // namespace details
+
+} // namespace thp
+
+#endif // PERIODIC_TASK_HPP_
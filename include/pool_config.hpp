@@ -0,0 +1,41 @@
+#ifndef POOL_CONFIG_HPP__
+#define POOL_CONFIG_HPP__
+
+#include <cstdint>
+#include <thread>
+
+namespace thp {
+
+// how workers receive tasks from job queue
+enum class dispatch_mode : uint8_t
+{
+  eShared = 0,       // all workers pop from scheduler output deque
+  eWorkStealing = 1, // per worker deque, idle workers steal from random victims
+  eDecentralized = 2,// like eWorkStealing, but out of work worker takes its next
+                     // batch from task queues itself (schedule_algo::apply(stats, tid)),
+                     // scheduler thread only rebalances periodically
+};
+
+// what idle workers do while waiting for tasks
+enum class wait_strategy : uint8_t
+{
+  eCondVar = 0,   // block on shared condition variable (legacy)
+  ePark = 1,      // park on own futex slot, exactly N workers woken for N tasks
+  eSpinPark = 2,  // bounded spin with cpu pause, then park like ePark
+  eBusyPoll = 3,  // never sleep, burns a core per idle worker
+};
+
+struct pool_config {
+  unsigned max_threads = std::thread::hardware_concurrency();
+  dispatch_mode dispatch = dispatch_mode::eShared;
+  // any dispatch mode: when workers are parked and no task is queued,
+  // scheduled or on a worker deque, FIFO tasks submitted from outside the
+  // pool are handed straight to a parked worker, bypassing scheduler thread
+  bool direct_dispatch = false;
+  // eCondVar with direct_dispatch behaves like ePark
+  wait_strategy wait = wait_strategy::eCondVar;
+};
+
+} // namespace thp
+
+#endif // POOL_CONFIG_HPP__
@@ -0,0 +1,45 @@
+#ifndef PRIORITY_LEVELS_HPP_
+#define PRIORITY_LEVELS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace thp {
+
+// 64 levels, higher value runs first
+enum class level : uint8_t
+{
+  eLowest = 0,
+  eLow = 16,
+  eNormal = 32,
+  eHigh = 48,
+  eHighest = 63,
+};
+
+//
+// number of distinct levels of a bounded priority type, 0 if unbounded.
+// Bounded types get a bucket queue (see bucket_taskq.hpp) instead of a heap,
+// specialize for own enums: value v maps to bucket v, clamped to [0, levels)
+//
+template <typename Prio>
+struct priority_levels : std::integral_constant<std::size_t, 0> {};
+
+// 8 bit unsigned integrals, 256 levels
+template <typename Prio>
+requires std::is_integral_v<Prio> && std::is_unsigned_v<Prio> && (sizeof(Prio) == 1) && (!std::is_same_v<Prio, bool>)
+struct priority_levels<Prio> : std::integral_constant<std::size_t, std::numeric_limits<Prio>::max() + 1u> {};
+
+template <>
+struct priority_levels<level> : std::integral_constant<std::size_t, 64> {};
+
+template <typename Prio>
+inline constexpr std::size_t priority_levels_v = priority_levels<Prio>::value;
+
+template <typename Prio>
+concept bounded_priority = priority_levels_v<Prio> > 0;
+
+} // namespace thp
+
+#endif // PRIORITY_LEVELS_HPP_
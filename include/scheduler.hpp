@@ -1,6 +1,7 @@
 #ifndef SCHEDULER_HPP_
 #define SCHEDULER_HPP_
 
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 
@@ -10,12 +11,19 @@
 
 namespace thp {
 
+// algorithms are only run by scheduler thread, update_algorithm may be
+// called from any thread, the switch takes effect on the next tick
 class task_scheduler {
 public:
-  explicit task_scheduler();
+  explicit task_scheduler(sched_algos::names initial = sched_algos::eFairShare);
+  // std::out_of_range for an unknown name
   void update_algorithm(sched_algos::names new_algo);
+  sched_algos::names algorithm() const;
+  // input queues of the job queue, fixed for scheduler's lifetime
+  void install(const std::vector<task_queue*>& qs);
   void compute_stats(statistics& stats);
-  void reschedule_worker(const statistics&, std::thread::id);
+  // worker side scheduling, batch for worker tid, returns its size
+  int reschedule_worker(statistics&, std::thread::id);
   void apply(statistics& stats);
 
   virtual ~task_scheduler() = default;
@@ -26,7 +34,12 @@ protected:
 
 private:
   std::unordered_map<sched_algos::names, std::shared_ptr<sched_algos::schedule_algo>> all_algos;
-  std::shared_ptr<sched_algos::schedule_algo> algo;
+  std::atomic<std::shared_ptr<sched_algos::schedule_algo>> algo;
+  // same algo for workers, all_algos keeps it alive, no refcount traffic
+  std::atomic<sched_algos::schedule_algo*> worker_algo;
+  std::atomic<sched_algos::names> name;
+  // batch scale from compute_stats, log2 of factor over run time estimate
+  int batch_shift;
 };
 
 } // namespace thp
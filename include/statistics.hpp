@@ -5,9 +5,11 @@
 #include <deque>
 #include <memory>
 #include <chrono>
+#include <vector>
 
 #include "include/configuration.hpp"
 #include "include/task_queue.hpp"
+#include "include/task_buffer.hpp"
 #include "include/executable.hpp"
 #include "include/all_priority_types.hpp"
 
@@ -20,7 +22,7 @@ struct workerpool_stats {
 };
 
 struct outputs {
-  std::deque<std::unique_ptr<executable>>* cur_output;
+  task_buffer* cur_output;
   std::size_t new_tasks;
 
   outputs& reset() {
@@ -32,18 +34,37 @@ struct outputs {
 struct inputs {
   std::vector<task_queue*>& qs;
   std::size_t num_tasks;
+  // tasks per worker per tick, < 0 moves everything queued
   int load_factor;
+  // relative share of each queue in qs, see fairshare_algo
+  const std::vector<unsigned>& weights;
 };
 
 struct jobq_stats {
-  const inputs in;
+  inputs in;
   outputs out;
 };
 
+// measured by job queue each tick, smoothed and acted on by
+// task_scheduler::compute_stats
+struct sched_stats {
+  // samples since previous tick, zero when there were none
+  std::chrono::nanoseconds exec_sample;
+  std::chrono::nanoseconds wait_sample;
+  std::size_t idle_workers;
+  // moving averages
+  std::chrono::nanoseconds exec_time;   // task run time
+  std::chrono::nanoseconds wait_time;   // time task sits in scheduler output
+  // decisions, batch is load_factor * num_workers
+  std::size_t batch;
+  std::chrono::nanoseconds linger;      // wait for a partial batch to fill up
+};
+
 struct statistics {
   std::chrono::system_clock::time_point ts;
   struct jobq_stats jobq;
   struct workerpool_stats pool;
+  struct sched_stats sched{};
 } __attribute__((aligned(4)));
 
 //} // namespace stats
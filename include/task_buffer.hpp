@@ -0,0 +1,59 @@
+#ifndef TASK_BUFFER_HPP_
+#define TASK_BUFFER_HPP_
+
+#include <vector>
+
+#include "include/inplace_task.hpp"
+
+namespace thp {
+
+//
+// FIFO buffer of tasks stored by value, used as scheduler output.
+// Consumed slots are only reclaimed when buffer drains, so a buffer which is
+// filled and drained repeatedly keeps its capacity and doesn't allocate.
+//
+class task_buffer {
+public:
+  task_buffer() : head{0}, data{} {}
+
+  task_buffer(task_buffer&&) = default;
+  task_buffer& operator = (task_buffer&&) = default;
+
+  std::size_t size() const { return data.size() - head; }
+  bool empty() const       { return head == data.size(); }
+
+  inplace_task& front()                         { return data[head]; }
+  inplace_task& operator[](std::size_t i)       { return data[head + i]; }
+
+  void pop_front() {
+    data[head++].reset();
+    if (head == data.size()) clear();
+  }
+
+  template <typename... Args>
+  inplace_task& emplace_back(Args&&... args) { return data.emplace_back(std::forward<Args>(args)...); }
+  void push_back(inplace_task&& t)            { data.push_back(std::move(t)); }
+
+  void reserve(std::size_t n) { data.reserve(head + n); }
+
+  // reclaims consumed slots once they outnumber live ones, for a buffer
+  // which is never drained; keeps capacity
+  void compact() {
+    if (head < size()) return;
+    data.erase(data.begin(), data.begin() + head);
+    head = 0;
+  }
+
+  void clear() {
+    data.clear();
+    head = 0;
+  }
+
+private:
+  std::size_t head;
+  std::vector<inplace_task> data;
+};
+
+} // namespace thp
+
+#endif // TASK_BUFFER_HPP_
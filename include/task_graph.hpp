@@ -0,0 +1,186 @@
+#ifndef TASK_GRAPH_HPP_
+#define TASK_GRAPH_HPP_
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "include/future.hpp"
+#include "include/inplace_task.hpp"
+
+namespace thp {
+
+//
+// tasks with dependencies between them (acyclic), built once and run any
+// number of times with threadpool::run(graph).
+//
+// Every node carries an atomic count of unfinished predecessors. A node
+// which finishes counts down its successors, one which reaches zero is run
+// right after on the same worker, further ones are submitted to the pool.
+// No worker waits on another node's result. Finished graph completes the
+// future returned by run(), topology isn't touched by a run, so next run
+// only resets the counters.
+//
+// First exception thrown by a node fails the run, nodes not started yet are
+// skipped (counted down, not run) and the exception goes to run's future.
+//
+class task_graph {
+public:
+  using node_id = std::size_t;
+  using submit_fn = std::function<void(inplace_task&&)>;
+
+  task_graph() = default;
+  task_graph(const task_graph&) = delete;
+  task_graph& operator = (const task_graph&) = delete;
+  ~task_graph() = default;
+
+  // new node running fn(args...), no dependencies yet
+  template <typename Fn, typename... Args>
+  requires std::invocable<Fn,Args...>
+  node_id emplace(Fn&& fn, Args&&... args) {
+    nodes.push_back({[fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)] () mutable {
+      std::invoke(fn, args...);
+    }, {}, 0});
+    dirty = true;
+    return nodes.size() - 1;
+  }
+
+  // after starts only once before has finished
+  void precede(node_id before, node_id after) {
+    nodes.at(before).succ.push_back(after);
+    ++nodes.at(after).deps;
+    dirty = true;
+  }
+
+  std::size_t size() const { return nodes.size(); }
+  bool running() const { return active.load(std::memory_order::acquire); }
+
+  // submits nodes without dependencies, throws std::invalid_argument when
+  // graph has a cycle and std::logic_error when it is running already
+  thp::future<void> start(submit_fn fn) {
+    if (active.exchange(true, std::memory_order::acq_rel))
+      throw std::logic_error("task_graph is running");
+    try {
+      if (dirty) validate();
+    }
+    catch(...) {
+      active.store(false, std::memory_order::release);
+      throw;
+    }
+
+    promise<void> p;
+    auto fut = p.get_future();
+    if (nodes.empty()) {
+      active.store(false, std::memory_order::release);
+      p.set_value();
+      return fut;
+    }
+
+    submit = std::move(fn);
+    for (node_id i = 0; i < nodes.size(); ++i) pending[i].store(nodes[i].deps, std::memory_order::relaxed);
+    remaining.store(nodes.size(), std::memory_order::relaxed);
+    failed.store(false, std::memory_order::relaxed);
+    error = nullptr;
+    done.emplace(std::move(p));
+
+    // submit publishes the counters along with the task
+    for (auto r : roots) submit(task(r));
+    return fut;
+  }
+
+private:
+  struct node {
+    std::function<void()> fn;
+    std::vector<node_id> succ;
+    unsigned deps;
+  };
+
+  inplace_task task(node_id id) {
+    return inplace_task([this, id] { execute(id); });
+  }
+
+  // nothing on this is touched after remaining is counted down, unless
+  // this worker took the last node: the graph may be gone by then
+  void execute(node_id id) {
+    const auto none = nodes.size();
+    for (;;) {
+      auto& n = nodes[id];
+      if (!failed.load(std::memory_order::relaxed)) {
+        try {
+          n.fn();
+        }
+        catch(...) {
+          if (!failed.exchange(true, std::memory_order::acq_rel)) error = std::current_exception();
+        }
+      }
+
+      auto next = none;
+      for (auto s : n.succ) {
+        if (pending[s].fetch_sub(1, std::memory_order::acq_rel) != 1) continue;
+        if (next == none) next = s;
+        else submit(task(s));
+      }
+      if (remaining.fetch_sub(1, std::memory_order::acq_rel) == 1) return finish();
+      if (next == none) return;
+      id = next;
+    }
+  }
+
+  // last node done, graph may be destroyed or run again once p is set
+  void finish() {
+    auto p = std::move(*done);
+    done.reset();
+    auto e = std::exchange(error, nullptr);
+    active.store(false, std::memory_order::release);
+    if (e) p.set_exception(std::move(e));
+    else   p.set_value();
+  }
+
+  // roots and counters for the current topology, Kahn's algorithm finds cycles
+  void validate() {
+    for (auto& n : nodes)
+      for (auto s : n.succ)
+        if (s >= nodes.size()) throw std::out_of_range("task_graph node");
+
+    roots.clear();
+    std::vector<unsigned> deps(nodes.size());
+    std::vector<node_id> order;
+    for (node_id i = 0; i < nodes.size(); ++i) {
+      deps[i] = nodes[i].deps;
+      if (0 == deps[i]) order.push_back(i);
+    }
+    roots = order;
+    for (std::size_t k = 0; k < order.size(); ++k)
+      for (auto s : nodes[order[k]].succ)
+        if (0 == --deps[s]) order.push_back(s);
+    if (order.size() != nodes.size()) throw std::invalid_argument("task_graph has a cycle");
+
+    if (capacity < nodes.size()) {
+      pending = std::make_unique<std::atomic<unsigned>[]>(nodes.size());
+      capacity = nodes.size();
+    }
+    dirty = false;
+  }
+
+  std::vector<node> nodes{};
+  std::vector<node_id> roots{};
+  bool dirty{false};
+
+  // per run state
+  std::unique_ptr<std::atomic<unsigned>[]> pending{};
+  std::size_t capacity{0};
+  std::atomic<std::size_t> remaining{0};
+  std::atomic<bool> active{false};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error{};
+  std::optional<promise<void>> done{};
+  submit_fn submit{};
+};
+
+} // namespace thp
+
+#endif // TASK_GRAPH_HPP_
@@ -3,17 +3,39 @@
 
 #include <deque>
 #include <memory>
+#include <ranges>
 #include <shared_mutex>
 
 #include "include/task_type.hpp"
 #include "include/traits.hpp"
+#include "include/inplace_task.hpp"
+#include "include/task_buffer.hpp"
+#include "include/dary_heap.hpp"
 
 namespace thp {
 
+// wrap any supported task form into by value inplace task
+template <typename C>
+inline inplace_task to_inplace_task(C&& t) {
+  using T = std::remove_cvref_t<C>;
+  if constexpr (std::is_same_v<T, inplace_task>) {
+    return std::move(t);
+  }
+  else if constexpr (traits::is_unique_ptr<T>::value) {
+    return [p = std::move(t)] { p->execute(); };
+  }
+  else if constexpr (std::is_base_of_v<executable, T>) {
+    return [x = std::move(t)] () mutable { x.execute(); };
+  }
+  else {
+    static_assert(std::is_base_of_v<executable, T>, "type is not supported");
+  }
+}
+
 // task queue interface
 struct task_queue {
-  virtual std::size_t pop(std::unique_ptr<executable>&) = 0;
-  virtual std::size_t pop_n(std::deque<std::unique_ptr<executable>>& out, std::size_t n = 1) = 0;
+  virtual std::size_t pop(inplace_task&) = 0;
+  virtual std::size_t pop_n(task_buffer& out, std::size_t n = 1) = 0;
   virtual std::size_t len() const = 0;
   virtual bool empty() const { return 0u == len(); }
   virtual ~task_queue() = default;
@@ -21,6 +43,7 @@ struct task_queue {
 
 //
 // one executable container queue
+// FIFO deque for void priority, d-ary max heap otherwise
 //
 template<typename Prio, typename TaskComp = std::less<comparable_task<Prio>>>
 class priority_taskq : public task_queue {
@@ -33,6 +56,10 @@ class priority_taskq : public task_queue {
 	  };
   };
 
+  using container_type = std::conditional_t<std::is_void_v<Prio>,
+                                            std::deque<value_type>,
+                                            dary_heap<value_type, value_compare>>;
+
   template <typename C>
   constexpr decltype(auto) to_value_type(C&& t)
   {
@@ -72,38 +99,35 @@ public:
     return *this;
   }
 
-  constexpr std::size_t pop(std::unique_ptr<executable>& t) override {
+  constexpr std::size_t pop(inplace_task& t) override {
     std::unique_lock l(mu);
     if (tasks.empty()) return 0;
 
     if constexpr (std::is_same_v<void, Prio>) {
-    	t = std::move(tasks.front());
+    	t = to_inplace_task(std::move(tasks.front()));
     	tasks.pop_front();
     }
     else {
-		  std::ranges::pop_heap(tasks, value_compare());
-		  t = std::move(tasks.back());
-		  tasks.pop_back();
+		  t = to_inplace_task(tasks.pop());
     }
 	  return 1;
   }
 
-  constexpr std::size_t pop_n(std::deque<std::unique_ptr<executable>>& out, std::size_t n) {
+  constexpr std::size_t pop_n(task_buffer& out, std::size_t n) override {
     std::unique_lock l(mu);
     if (tasks.empty()) return 0;
 
     n = std::min(n, tasks.size());
+    out.reserve(out.size() + n);
 
     if constexpr (std::is_same_v<void, Prio>) {
-      std::move(tasks.begin(), std::next(tasks.begin(), n), std::back_inserter(out));
+      std::for_each(tasks.begin(), std::next(tasks.begin(), n), [&](auto&& t) { out.emplace_back(to_inplace_task(std::move(t))); });
       tasks.erase(tasks.begin(), std::next(tasks.begin(), n));
+      return n;
     } else {
-      std::ranges::sort_heap(tasks, value_compare());
-      std::move(tasks.begin(), std::next(tasks.begin(), n), std::back_inserter(out));
-      tasks.erase(tasks.begin(), std::next(tasks.begin(), n));
-      std::ranges::make_heap(tasks, value_compare());
+      // k highest priority tasks, O(k log N), rest of the heap stays as is
+      return tasks.pop_n(n, [&](value_type&& t) { out.emplace_back(to_inplace_task(std::move(t))); });
     }
-    return 0;
   }
 
   template<typename... C>
@@ -126,28 +150,28 @@ public:
 
 protected:
   constexpr std::size_t _insert(value_type&& p) {
-    tasks.emplace_back(std::move(p));
-    if constexpr (!std::is_same_v<void, Prio>) {
-      std::ranges::push_heap(tasks, value_compare());
-    }
+    if constexpr (std::is_same_v<void, Prio>) tasks.emplace_back(std::move(p));
+    else                                      tasks.push(std::move(p));
     return 1;
   }
 
   template<typename T>
   constexpr std::size_t _insert(std::vector<T>&& c) {
     auto n = c.size();
-    std::ranges::for_each(c, [&](auto&& t) {
-      _insert(to_value_type(std::move(t)));
-    });
-
-    if constexpr (!std::is_same_v<void, Prio>) {
-      std::ranges::make_heap(tasks, value_compare());
+    if constexpr (std::is_same_v<void, Prio>) {
+      std::ranges::for_each(c, [&](auto&& t) {
+        _insert(to_value_type(std::move(t)));
+      });
+    }
+    else {
+      auto vals = c | std::views::transform([this](auto& t) -> value_type { return to_value_type(std::move(t)); });
+      tasks.push(vals.begin(), vals.end());
     }
     return n;
   }
 
   mutable std::mutex mu;
-  std::deque<value_type> tasks;
+  container_type tasks;
 };
 
 } // namespace thp
@@ -5,14 +5,54 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <optional>
 #include <type_traits>
 #include <compare>
 
 #include "include/executable.hpp"
 #include "include/register_types.hpp"
+#include "include/future.hpp"
+#include "include/memory_pool.hpp"
 
 namespace thp {
 
+namespace details {
+
+// bound task callable and promise of its std::future, if one was taken.
+// Owned by regular_task, lives in memory pool.
+template <typename Ret>
+struct callable {
+  virtual Ret operator () () = 0;
+  virtual void destroy() noexcept = 0;
+
+  std::optional<std::promise<Ret>> std_p;
+
+  struct deleter {
+    void operator () (callable* c) const noexcept { c->destroy(); }
+  };
+
+protected:
+  ~callable() = default;
+};
+
+template <typename Ret, typename Fn>
+struct callable_impl final : callable<Ret> {
+  explicit callable_impl(Fn&& f) : fn{std::move(f)} {}
+  Ret operator () () override { return fn(); }
+  void destroy() noexcept override { memory::pool_delete(this); }
+  Fn fn;
+};
+
+template <typename Ret>
+using callable_ptr = std::unique_ptr<callable<Ret>, typename callable<Ret>::deleter>;
+
+template <typename Ret, typename Fn>
+callable_ptr<Ret> make_callable(Fn&& f) {
+  return callable_ptr<Ret>(memory::pool_new<callable_impl<Ret, std::decay_t<Fn>>>(std::forward<Fn>(f)));
+}
+
+} // namespace details
+
 template <typename Ret>
 class regular_task: public virtual executable {
 public:
@@ -20,17 +60,55 @@ public:
   requires std::regular_invocable<Fn,Args...>
            && std::same_as<Ret, std::invoke_result_t<Fn,Args...>>
   constexpr explicit regular_task(Fn&& fn, Args&&... args)
-    : pt{std::bind(std::forward<Fn>(fn), std::forward<Args>(args)...)}
+    : fn{details::make_callable<Ret>(std::bind(std::forward<Fn>(fn), std::forward<Args>(args)...))}
   {}
 
+  // result goes straight into the promise of whichever future was taken,
+  // both promise states come from memory pool
   void execute() override {
-    pt();
+    if (lite.valid()) return lite.set_from(*fn);
+    auto& std_p = fn->std_p;
+    if (!std_p) {
+      try { (*fn)(); } catch(...) {} // nobody is waiting for the result
+      return;
+    }
+    try {
+      if constexpr (std::is_void_v<Ret>) {
+        (*fn)();
+        std_p->set_value();
+      }
+      else {
+        std_p->set_value((*fn)());
+      }
+    }
+    catch(...) {
+      std_p->set_exception(std::current_exception());
+    }
+  }
+
+  std::future<Ret> future() {
+    if (lite.valid() || fn->std_p) throw std::future_error(std::future_errc::future_already_retrieved);
+    fn->std_p.emplace(std::allocator_arg, memory::pool_allocator<Ret>{});
+    return fn->std_p->get_future();
   }
 
-  std::future<Ret> future() { return pt.get_future(); }
+  // ready to run again with fresh results, futures of the previous run
+  // keep theirs
+  void reset() {
+    fn->std_p.reset();
+    lite = thp::promise<Ret>(nullptr);
+  }
+
+  // result as thp::future instead, use either this or future(), not both
+  thp::future<Ret> lite_future() {
+    if (lite.valid() || fn->std_p) throw std::future_error(std::future_errc::future_already_retrieved);
+    lite = thp::promise<Ret>();
+    return lite.get_future();
+  }
 
 protected:
-  std::packaged_task<Ret()> pt;
+  details::callable_ptr<Ret> fn;
+  thp::promise<Ret> lite{nullptr};
 };
 
 template<typename Prio = void>
@@ -43,6 +121,8 @@ struct comparable_task : virtual public executable {
     return *this;
   }
 
+  constexpr const Prio& get_priority() const { return priority; }
+
   template<typename T>
   //requires std::totally_ordered_with<Prio, typename T::PriorityType>
   constexpr auto operator <=> (const T& rhs) const
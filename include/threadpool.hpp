@@ -6,6 +6,7 @@
 #include <future>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <tuple>
 #include <type_traits>
 #include <vector>
@@ -16,6 +17,8 @@
 
 #include "include/partitioner.hpp"
 #include "include/algos/partitioner/equal_size.hpp"
+#include "include/algos/sorting/merge_path.hpp"
+#include "include/algos/sorting/radix.hpp"
 #include "include/util.hpp"
 #include "include/jobq.hpp"
 #include "include/scheduler.hpp"
@@ -27,6 +30,11 @@
 #include "include/all_priority_types.hpp"
 #include "include/concepts.hpp"
 #include "include/job_type.hpp"
+#include "include/pool_config.hpp"
+#include "include/memory_pool.hpp"
+#include "include/future.hpp"
+#include "include/periodic_task.hpp"
+#include "include/task_graph.hpp"
 
 namespace thp {
 class threadpool final {
@@ -34,6 +42,7 @@ class threadpool final {
 
 public:
   explicit threadpool(unsigned max_threads = std::thread::hardware_concurrency());
+  explicit threadpool(const pool_config& cfg);
 
   // waits till condition of no tasks is satisfied
   void drain();
@@ -45,100 +54,257 @@ public:
   // graceful shutdown
   void shutdown();
 
+  unsigned num_workers() const { return max_threads_; }
+
   // could be heterogeneous task types
+  // schedule<thp::future>(...) returns lightweight thp::future instead of std::future
+  template <template<typename> class Future = std::future>
   constexpr decltype(auto) schedule(kncpt::ThreadPoolTask auto&&... args) {
-    return std::make_tuple(jobq_.schedule_task(args)...);
+    return std::make_tuple(jobq_.template schedule_task<Future>(args)...);
   }
 
-  template<typename T>
+  // runs job on pool workers, at most work.num_workers() of them at a time
+  // with the caller counted in. Caller claims tasks as well, so run() from
+  // inside a task doesn't wait on workers which may all be busy.
+  template<template<typename> class Future = std::future, typename T>
   constexpr decltype(auto) run(job<T>& work) {
-    worker_pool workers;
-    workers.start_n_thread(work.num_workers(), &job<T>::worker_fn, &work);
-    //work.wait();
-    std::deque<std::future<typename T::ReturnType>> ret;
-    work.futures(std::back_inserter(ret));
-    for(auto&& f: ret) f.wait();
+    const std::size_t cap = work.num_workers() ? std::min<std::size_t>(work.num_workers(), max_threads_) : max_threads_;
+    const auto runners = std::max<std::size_t>(1u, std::min(cap, work.size()));
+    work.prepare(runners);
+
+    std::deque<Future<typename T::ReturnType>> ret;
+    work.template futures<Future>(std::back_inserter(ret));
+    for (auto helpers = runners; helpers > 1; --helpers)
+      jobq_.submit(work.runner());
+    work.runner()();
+
+    for(auto&& f: ret) wait(f);
     return ret;
   }
 
+  // f.wait(), but a pool worker runs other queued tasks meanwhile (its own
+  // first), so nested parallel work neither needs spare workers nor
+  // deadlocks when all of them wait
+  template <typename Future>
+  void wait(const Future& f) {
+    if (!jobq_.is_worker()) return f.wait();
+    while (!is_ready(f)) {
+      if (!jobq_.help_one()) f.wait_for(Static::help_wait_backoff());
+    }
+  }
+
+  // wait(f), then f.get()
+  template <typename Future>
+  decltype(auto) get(Future& f) {
+    wait(f);
+    return f.get();
+  }
+
+  // runs graph on pool workers, nodes are released as their dependencies
+  // finish, nothing blocks meanwhile. Graph must outlive the returned future
+  // getting ready, then it can be run again.
+  thp::future<void> run(task_graph& graph) {
+    return graph.start([this](inplace_task&& t) { jobq_.submit(std::move(t)); });
+  }
+
+  // share of scheduler output for Prio tasks relative to other priority
+  // types (weighted deficit round robin across queues), default 1
+  template <typename Prio>
+  void set_weight(unsigned w) { jobq_.template set_weight<Prio>(w); }
+
+  // deadline_task which can no longer meet its deadline at dispatch is kept, dropped or demoted
+  void set_deadline_policy(deadline_policy p) { jobq_.deadline_queue().set_policy(p); }
+  deadline_stats deadlines() const { return jobq_.deadline_queue().stats(); }
+
+  // switch scheduling algorithm while running, eAuto picks one from live
+  // statistics (see auto_select.hpp)
+  void set_algorithm(sched_algos::names n) { jobq_.set_algorithm(n); }
+  sched_algos::names algorithm() const { return jobq_.algorithm(); }
+
+  // run/wait time estimates and batch size the scheduler settled on
+  sched_stats scheduler_stats() const { return jobq_.scheduler_stats(); }
+
   template <typename Clock> 
   constexpr decltype(auto) run_for(typename Clock::duration dur) {}
 
+  // pipeline t, fn..., each stage is submitted to pool when previous one
+  // completes and gets its result by move (void result, no argument).
+  // Exception skips the remaining stages and goes to the returned
+  // thp::future. t is a callable, run as by async(), or a thp::future to
+  // continue from. No worker waits for a stage meanwhile.
   template <typename Task, typename...Callables>
-  constexpr decltype(auto) chain(Task&& t, Callables&&... fn) {}
+  auto chain(Task&& t, Callables&&... fn) {
+    if constexpr (traits::is_specialization<std::remove_cvref_t<Task>, thp::future>::value)
+      return chain_stages(std::move(t), std::forward<Callables>(fn)...);
+    else
+      return chain_stages(async(std::forward<Task>(t)), std::forward<Callables>(fn)...);
+  }
 
+  // same as schedule(make_task(fn, args...)), but callable, arguments and promise
+  // are stored inline in the queued task instead of a pool block of their own.
+  // Promise state comes from pool on both paths, common case submission
+  // doesn't call malloc (see examples/alloc_count.cpp)
   template <typename Fn, typename... Args>
   requires std::invocable<Fn,Args...>
   constexpr decltype(auto) enqueue(Fn&& fn, Args&&... args) {
-    return schedule(make_task(std::forward<Fn>(fn), std::forward<Args>(args)...));
+    using Ret = std::invoke_result_t<Fn, Args...>;
+    std::promise<Ret> p(std::allocator_arg, memory::pool_allocator<Ret>{});
+    auto fut = p.get_future();
+    jobq_.submit([p = std::move(p), fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)] () mutable {
+      try {
+        if constexpr (std::is_void_v<Ret>) {
+          std::invoke(fn, args...);
+          p.set_value();
+        }
+        else {
+          p.set_value(std::invoke(fn, args...));
+        }
+      }
+      catch(...) {
+        p.set_exception(std::current_exception());
+      }
+    });
+    return std::make_tuple(std::move(fut));
+  }
+
+  // fire and forget, no future, no result storage. Exception escaping fn goes
+  // to exception handler (see set_exception_handler)
+  template <typename Fn, typename... Args>
+  requires std::invocable<Fn,Args...>
+  void post(Fn&& fn, Args&&... args) {
+    jobq_.submit([this, fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)] () mutable {
+      try {
+        std::invoke(fn, args...);
+      }
+      catch(...) {
+        handle_exception(std::current_exception());
+      }
+    });
   }
 
+  // post(fn, args...) at tp, timer thread holds it till then. O(1) schedule
+  // and cancel, resolution is Static::timer_tick()
+  template <typename Fn, typename... Args>
+  requires std::invocable<Fn,Args...>
+  timer_id post_at(std::chrono::steady_clock::time_point tp, Fn&& fn, Args&&... args) {
+    return jobq_.timer().schedule_at(tp, [this, fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)] () mutable {
+      post(std::move(fn), std::move(args)...);
+    });
+  }
+
+  template <typename Rep, typename Period, typename Fn, typename... Args>
+  requires std::invocable<Fn,Args...>
+  timer_id post_after(std::chrono::duration<Rep, Period> d, Fn&& fn, Args&&... args) {
+    return post_at(std::chrono::steady_clock::now() + d, std::forward<Fn>(fn), std::forward<Args>(args)...);
+  }
+
+  // false if timer already fired (or was cancelled)
+  bool cancel(timer_id id) { return jobq_.timer().cancel(id); }
+
+  // fn(args...) every cfg.period (see periodic_task.hpp). Series is re-armed
+  // on timer thread after each run, no worker is held between runs.
+  template <typename Fn, typename... Args>
+  requires std::invocable<Fn,Args...>
+  auto schedule_every(const periodic_config& cfg, Fn&& fn, Args&&... args) {
+    using Ret = std::invoke_result_t<Fn,Args...>;
+    auto body = [fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)] () mutable -> Ret {
+      return std::invoke(fn, args...);
+    };
+    auto p = std::make_shared<details::periodic_impl<Ret, decltype(body)>>(cfg, jobq_.timer(),
+      [this](inplace_task&& t) { jobq_.submit(std::move(t)); },
+      [this](std::exception_ptr e) { handle_exception(std::move(e)); },
+      std::move(body));
+    p->start();
+    return std::shared_ptr<periodic<Ret>>(std::move(p));
+  }
+
+  // post every callable of range, scheduler is woken once for the lot
+  template <std::ranges::input_range R>
+  requires std::invocable<std::ranges::range_reference_t<R>>
+  void post_bulk(R&& fns) {
+    jobq_.submit_bulk(std::ranges::begin(fns), std::ranges::end(fns), [this](auto&& fn) {
+      using Fn = std::remove_cvref_t<decltype(fn)>;
+      return inplace_task([this, fn = static_cast<std::conditional_t<std::is_rvalue_reference_v<R&&>, Fn&&, const Fn&>>(fn)] () mutable {
+        try {
+          std::invoke(fn);
+        }
+        catch(...) {
+          handle_exception(std::current_exception());
+        }
+      });
+    });
+  }
+
+  using exception_handler = std::function<void(std::exception_ptr)>;
+
+  // handler for exceptions escaping posted tasks, called on worker thread
+  void set_exception_handler(exception_handler fn);
+
+  // like enqueue, but result is thp::future, whose state comes from pool and
+  // supports then() continuations
+  template <typename Fn, typename... Args>
+  requires std::invocable<Fn,Args...>
+  decltype(auto) async(Fn&& fn, Args&&... args) {
+    using Ret = std::invoke_result_t<Fn, Args...>;
+    promise<Ret> p;
+    auto fut = p.get_future();
+    jobq_.submit([p = std::move(p), fn = std::forward<Fn>(fn), ...args = std::forward<Args>(args)] () mutable {
+      p.set_from([&] { return std::invoke(fn, args...); });
+    });
+    return fut;
+  }
+
+  // parallel mergesort, for benchmarks see examples/sort.cpp. Chunks of
+  // the range are sorted by std::ranges::sort, then merged pairwise level
+  // by level, every level cut into one piece per worker by merge path (see
+  // merge_path.hpp). Levels ping-pong between the range and one scratch
+  // buffer. Ranges up to Static::stl_sort_cutoff() and types which aren't
+  // default constructible are sorted on one thread. Arithmetic keys with
+  // std::ranges::less or greater go to radix sort instead, from
+  // Static::radix_sort_cutoff() on.
   template <std::random_access_iterator I, std::sentinel_for<I> S,
             typename Comp = std::ranges::less, typename Proj = std::identity>
   requires std::sortable<I, Comp, Proj>
   constexpr decltype(auto) sort(I start, S end, Comp cmp = {}, Proj prj = {}) {
-
-    std::function<std::tuple<I,S>(I, S, Comp, Proj)> tp_sort = [this, &tp_sort](I s, S e, Comp comp, Proj proj) {
-      using Ret = std::tuple<I, S>;
-      using Task = simple_task<Ret>;
-
-      const std::size_t len = std::ranges::distance(s, e);
-      if (len <= Static::stl_sort_cutoff()) {
-        std::ranges::sort(s, e, comp, proj);
+    return enqueue([this](I s, S e, Comp comp, Proj proj) {
+      const std::size_t n = std::ranges::distance(s, e);
+      const auto parts = std::min<std::size_t>(max_threads_, (n + Static::stl_sort_cutoff() - 1) / Static::stl_sort_cutoff());
+      constexpr bool less = std::same_as<Comp, std::ranges::less>;
+      constexpr bool greater = std::same_as<Comp, std::ranges::greater>;
+      if constexpr (sorting::radix_sortable<I, Proj> && (less || greater)) {
+        if (n > Static::radix_sort_cutoff()) {
+          radix_sort(s, n, std::max<std::size_t>(1u, parts), proj, greater);
+          return std::make_tuple(s, e);
+        }
       }
-      else {
-        // level merge of sorted ranges
-        auto level_merge_task = [this] (auto&& fut_vec) mutable {
-          //std::cerr << "level_merge_task: " << fut_vec.size() << std::endl;
-          auto one_merge = [](auto&& f1, auto&& f2) mutable {
-            auto [s1, e1] = f1.get();
-            auto [s2, e2] = f2.get();
-            assert(e1 == s2);
-            std::ranges::inplace_merge(s1, s2, e2);
-            return std::make_tuple(s1, e2);
-          };
-
-          std::vector<Task> merge_tasks;
-          const auto n = fut_vec.size();
-          merge_tasks.reserve(n % 2 != 0 ? (1 + n/2) : n/2);
-
-          for (size_t i = 0; i+1 < n; i += 2)
-            merge_tasks.emplace_back(make_task(one_merge, std::move(fut_vec[i]), std::move(fut_vec[i+1])));
-
-          //auto next_fut_vec = jobq_.schedule_task(std::move(merge_tasks));
-          auto merge_job = job<Task>(std::move(merge_tasks)).num_workers(std::clamp(n/2, 1lu, 16lu));
-          auto next_fut_vec = this->run(merge_job);
-          if (n % 2 != 0) {
-            next_fut_vec.emplace_back(std::move(fut_vec.back()));
-            fut_vec.pop_back();
-          }
-          //std::ranges::for_each(next_fut_vec, [](auto&& f) { f.get(); });
-
-          return next_fut_vec;
-        };
-
-        unsigned part_len = static_cast<unsigned>(len/std::thread::hardware_concurrency());
-        auto step = std::clamp(part_len, 2u, Static::stl_sort_cutoff());
-        std::vector<Task> tasks;
-        tasks.reserve(std::ceil(len/step));
-        for(std::size_t i = 0; i < len; i += step)
-          tasks.emplace_back(make_task(tp_sort, s+i, s+std::min(i+step, len), comp, proj));
-
-        auto works = job<Task>(std::move(tasks)).num_workers(max_threads_);
-        auto futs = this->run(works);
-        
-        //auto futs = jobq_.schedule_task(std::move(tasks));
-        while (futs.size() > 1) {
-          futs = level_merge_task(std::move(futs));
+      else if constexpr (std::default_initializable<std::iter_value_t<I>>) {
+        if (parts > 1) {
+          merge_sort(s, n, parts, comp, proj);
+          return std::make_tuple(s, e);
         }
-
-        std::ranges::for_each(futs, [](auto&& f) { f.wait(); });
       }
+      std::ranges::sort(s, e, comp, proj);
       return std::make_tuple(s, e);
-    };
+    }, std::move(start), std::move(end), std::move(cmp), std::move(prj));
+  }
 
-    return enqueue(tp_sort, std::forward<I>(start), std::forward<S>(end),
-                            std::forward<Comp>(cmp), std::forward<Proj>(prj));
+  // stable ascending sort by arithmetic key proj(x), integral or floating
+  // point, key isn't copied out. Parallel LSD radix sort (see radix.hpp),
+  // ranges up to Static::radix_sort_cutoff() use std::ranges::stable_sort.
+  template <std::random_access_iterator I, std::sentinel_for<I> S, typename Proj = std::identity>
+  requires std::sortable<I, std::ranges::less, Proj> && sorting::radix_sortable<I, Proj>
+  constexpr decltype(auto) radix_sort(I start, S end, Proj prj = {}) {
+    return enqueue([this](I s, S e, Proj proj) {
+      const std::size_t n = std::ranges::distance(s, e);
+      if (n <= Static::radix_sort_cutoff()) {
+        std::ranges::stable_sort(s, e, std::ranges::less{}, proj);
+      }
+      else {
+        const auto parts = std::clamp<std::size_t>(n / Static::stl_sort_cutoff(), 1u, max_threads_);
+        radix_sort(s, n, parts, proj, false);
+      }
+      return std::make_tuple(s, e);
+    }, std::move(start), std::move(end), std::move(prj));
   }
 
   // parallel algorithm, for benchmarks see examples/reduce.cpp
@@ -186,6 +352,47 @@ public:
     });
   }
 
+  // parallel prefix sums, for benchmarks see examples/scan.cpp. Two passes
+  // over part_algo partitions, see scan_parts. op has to be associative,
+  // not commutative. out may be s to scan in place. Result is future of
+  // the end of output.
+  template <
+    std::forward_iterator I, std::sentinel_for<I> S,
+    std::forward_iterator O,
+    typename BinaryOp,
+    typename PartAlgo = partition::EqualSize<I,S>
+  >
+  constexpr decltype(auto) inclusive_scan(I s, S e, O out, BinaryOp op, PartAlgo part_algo) {
+    return this->transform_inclusive_scan(s, e, out, std::move(op), std::identity(), std::move(part_algo));
+  }
+
+  template <
+    std::forward_iterator I, std::sentinel_for<I> S,
+    std::forward_iterator O,
+    typename T,
+    typename BinaryOp,
+    typename PartAlgo = partition::EqualSize<I,S>
+  >
+  constexpr decltype(auto) exclusive_scan(I s, S e, O out, T init, BinaryOp op, PartAlgo part_algo) {
+    return enqueue([=, this] () mutable {
+      return scan_parts<T>(s, e, out, std::optional<T>(std::move(init)), true, op, std::identity(), part_algo);
+    });
+  }
+
+  template <
+    std::forward_iterator I, std::sentinel_for<I> S,
+    std::forward_iterator O,
+    typename BinaryOp,
+    typename UnaryOp,
+    typename PartAlgo = partition::EqualSize<I,S>
+  >
+  constexpr decltype(auto) transform_inclusive_scan(I s, S e, O out, BinaryOp op, UnaryOp tr, PartAlgo part_algo) {
+    using T = std::remove_cvref_t<std::invoke_result_t<UnaryOp&, std::iter_reference_t<I>>>;
+    return enqueue([=, this] () mutable {
+      return scan_parts<T>(s, e, out, std::optional<T>{}, false, op, tr, part_algo);
+    });
+  }
+
   template<std::input_iterator I, std::sentinel_for<I> S, typename Fn>
   constexpr decltype(auto) for_each(I s, S e, Fn fn) {
     return std::ranges::for_each(s, e, [fn, this](auto&& x) { return enqueue(fn, x); });
@@ -195,10 +402,140 @@ public:
 
 protected:
   void print(std::ostream&, managed_stop_token);
+  void handle_exception(std::exception_ptr) noexcept;
 
   // quick shutdown, may not run all tasks
   void stop();
 
+  // sorts chunks, then merges them level by level, parts pieces each
+  template <std::random_access_iterator I, typename Comp, typename Proj>
+  void merge_sort(I s, std::size_t n, std::size_t parts, Comp& comp, Proj& proj) {
+    const auto chunk = (n + parts - 1) / parts;
+    run_parts(parts, [=](std::size_t q) {
+      std::ranges::sort(s + std::min(n, q * chunk), s + std::min(n, (q + 1) * chunk), comp, proj);
+    });
+
+    std::vector<std::iter_value_t<I>> buf(n);
+    std::vector<std::size_t> ranks(parts + 1);
+    auto level = [&](auto src, auto dst, std::size_t w) {
+      for (std::size_t q = 0; q <= parts; ++q) ranks[q] = sorting::level_rank(src, n, w, q * n / parts, comp, proj);
+      run_parts(parts, [=, &ranks](std::size_t q) {
+        sorting::merge_level(src, dst, n, w, q * n / parts, (q + 1) * n / parts, ranks[q], ranks[q + 1], comp, proj);
+      });
+    };
+    bool in_buf = false;
+    for (auto w = chunk; w < n; w *= 2, in_buf = !in_buf) {
+      if (in_buf) level(buf.begin(), s, w);
+      else        level(s, buf.begin(), w);
+    }
+    if (in_buf) move_parts(buf.begin(), s, n, parts);
+  }
+
+  // LSD radix sort, a byte per pass, passes where all keys share the
+  // byte are skipped. Histogram and scatter of a pass run parts chunks in
+  // parallel, offsets in between are a prefix sum over (digit, chunk).
+  template <std::random_access_iterator I, typename Proj>
+  void radix_sort(I s, std::size_t n, std::size_t parts, Proj& proj, bool descending) {
+    using U = sorting::radix_bits_t<I, Proj>;
+    const U mask = descending ? static_cast<U>(~U{0}) : U{0};
+    std::vector<std::iter_value_t<I>> buf(n);
+    std::vector<sorting::histogram> counts(parts);
+
+    auto pass = [&](auto src, auto dst, unsigned shift) {
+      run_parts(parts, [&, src, shift](std::size_t q) {
+        const auto b = q * n / parts;
+        counts[q] = sorting::radix_histogram(src + b, (q + 1) * n / parts - b, shift, mask, proj);
+      });
+      std::size_t sum = 0;
+      for (std::size_t d = 0; d < sorting::radix_buckets; ++d) {
+        std::size_t total = 0;
+        for (auto& c : counts) total += c[d];
+        if (total == n) return false;
+        for (auto& c : counts) sum += std::exchange(c[d], sum);
+      }
+      run_parts(parts, [&, src, dst, shift](std::size_t q) {
+        const auto b = q * n / parts;
+        sorting::radix_scatter(src + b, (q + 1) * n / parts - b, dst, shift, mask, proj, counts[q]);
+      });
+      return true;
+    };
+    bool in_buf = false;
+    for (unsigned shift = 0; shift < 8 * sizeof(U); shift += 8) {
+      if (in_buf ? pass(buf.begin(), s, shift) : pass(s, buf.begin(), shift))
+        in_buf = !in_buf;
+    }
+    if (in_buf) move_parts(buf.begin(), s, n, parts);
+  }
+
+  // moves [src, src+n) to dst in parts pieces
+  template <std::random_access_iterator I, std::random_access_iterator O>
+  void move_parts(I src, O dst, std::size_t n, std::size_t parts) {
+    run_parts(parts, [=](std::size_t q) {
+      std::move(src + q * n / parts, src + (q + 1) * n / parts, dst + q * n / parts);
+    });
+  }
+
+  // reduce, then scan: first pass folds every partition but the last in
+  // order, carries are a serial prefix over those sums starting from
+  // init, second pass scans every partition from its carry. Partition
+  // output starts at the same offset as its input.
+  template <typename T, typename I, typename S, typename O, typename BinaryOp, typename UnaryOp, typename PartAlgo>
+  O scan_parts(I s, S e, O out, std::optional<T> init, bool exclusive, BinaryOp op, UnaryOp tr, PartAlgo& part_algo) {
+    if (s == e) return out;
+    partitioner partitions(part_algo);
+    using Part = std::remove_cvref_t<decltype(*partitions.begin())>;
+    std::vector<Part> parts;
+    parts.reserve(partitions.count());
+    for (auto&& sr : partitions) parts.push_back(sr);
+
+    const auto k = parts.size();
+    std::vector<std::optional<T>> carry(k);
+    run_parts(k - 1, [&](std::size_t q) {
+      auto& acc = carry[q + 1];
+      for (auto&& x : parts[q]) acc = acc ? op(std::move(*acc), std::invoke(tr, x)) : T(std::invoke(tr, x));
+    });
+    carry[0] = std::move(init);
+    for (std::size_t q = 1; q < k; ++q) {
+      if (!carry[q]) carry[q] = carry[q - 1];
+      else if (carry[q - 1]) carry[q] = op(*carry[q - 1], std::move(*carry[q]));
+    }
+
+    run_parts(k, [&](std::size_t q) {
+      auto& p = parts[q];
+      auto o = std::next(out, std::distance(s, p.begin()));
+      if (exclusive)     std::transform_exclusive_scan(p.begin(), p.end(), o, *carry[q], op, tr);
+      else if (carry[q]) std::transform_inclusive_scan(p.begin(), p.end(), o, op, tr, *carry[q]);
+      else               std::transform_inclusive_scan(p.begin(), p.end(), o, op, tr);
+    });
+    return std::next(out, std::distance(s, parts.back().end()));
+  }
+
+  // fn(q) for q in [0, k) as a job, caller takes part, first exception
+  // is rethrown
+  template <typename Fn>
+  void run_parts(std::size_t k, Fn fn) {
+    std::vector<simple_task<void>> tasks;
+    tasks.reserve(k);
+    for (std::size_t q = 0; q < k; ++q) tasks.emplace_back([fn, q] { fn(q); });
+    auto work = job<simple_task<void>>(std::move(tasks));
+    for (auto&& f : this->run(work)) f.get();
+  }
+
+  template <typename Future>
+  static bool is_ready(const Future& f) {
+    if constexpr (requires { f.is_ready(); }) return f.is_ready();
+    else return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+
+  template <typename T>
+  thp::future<T> chain_stages(thp::future<T>&& f) { return std::move(f); }
+
+  template <typename T, typename Fn, typename... Rest>
+  auto chain_stages(thp::future<T>&& f, Fn&& fn, Rest&&... rest) {
+    auto next = std::move(f).then([this](inplace_task&& t) { jobq_.submit(std::move(t)); }, std::forward<Fn>(fn));
+    return chain_stages(std::move(next), std::forward<Rest>(rest)...);
+  }
+
 private:
   mutable std::mutex mu_;
   std::condition_variable_any shutdown_cv_;
@@ -209,6 +546,7 @@ private:
   worker_pool worker_pool_, managers_, book_keepers_;
   //std::unique_ptr<signal_handler> sighandler_;
   unsigned max_threads_;
+  std::atomic<std::shared_ptr<const exception_handler>> on_exception_;
 
   TP_DISALLOW_COPY_ASSIGN(threadpool)
 };
@@ -35,20 +35,21 @@ public:
     Base::set_priority(Clock::now());
   }
 
+  time_task(time_task&&) = default;
+  time_task& operator = (time_task&&) = default;
+
   constexpr decltype(auto) start_at(TimePoint&& tp) {
     Base::set_priority(std::forward<TimePoint>(tp));
     return *this;
   }
 
+  // job queue holds task in timer service till start time, so no sleeping here
   void execute() override {
-    // std::cerr << std::this_thread::get_id() << " : " <<
-    // (at-Clock::now()).count() << ", will sleep till " << std::endl;
-    std::this_thread::sleep_until(this->priority);
-    // std::cerr << std::this_thread::get_id() << " : " <<
-    // (at-Clock::now()).count() << ", wakeup, execute " << std::endl;
     Base::execute();
   }
 
+  TimePoint start_time() const { return this->priority; }
+
   virtual ~time_task() = default;
 };
 
@@ -67,6 +68,7 @@ public:
   explicit time_series_task(Fn &&fn, Args &&... args)
       : time_task<Ret, Clock>{std::forward<Fn>(fn), std::forward<Args>(args)...}
       , time_points{}
+      , cur{0}
       , results{new ResultBuffer(N)}
       , ret{}
   {
@@ -88,28 +90,32 @@ public:
     return ret.get_future();
   }
 
+  bool pending() const       { return cur < time_points.size(); }
+  TimePoint next_time() const { return time_points[cur]; }
+
+  // one point of the series, job queue re-arms timer for the next one
+  void run_next() {
+    results->put(regular_task<Ret>::future());
+    regular_task<Ret>::execute();
+    regular_task<Ret>::reset();
+    ++cur;
+  }
+
+  // only when run outside a pool, job queue uses run_next()
   void execute() override {
-    std::ranges::for_each(time_points, [&](auto&& tp) mutable {
-      //std::cerr << std::this_thread::get_id() << " : " <<
-      // (tp-Clock::now()).count() << ", will sleep till " << std::endl;
-      this->results->put(this->pt.get_future());
-
-      std::this_thread::sleep_until(tp);
-      //std::osyncstream(std::cerr) << std::this_thread::get_id() << " : " << (tp-Clock::now()).count() << ", wakeup, execute " << std::endl;
-
-      this->pt();
-      this->pt.reset();
-    });
-    std::cerr << "time task done" << std::endl;
+    while (pending()) {
+      std::this_thread::sleep_until(next_time());
+      run_next();
+    }
   }
 
   virtual ~time_series_task() = default;
 
 protected:
   std::vector<TimePoint> time_points;
+  std::size_t cur;
   std::shared_ptr<ResultBuffer> results;
   std::promise<std::shared_ptr<ResultBuffer>> ret;
-//  std::shared_ptr<std::vector<std::future<Ret>> results;
 };
 
 } // namespace thp
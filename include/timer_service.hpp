@@ -0,0 +1,115 @@
+#ifndef TIMER_SERVICE_HPP_
+#define TIMER_SERVICE_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
+#include "include/configuration.hpp"
+#include "include/inplace_task.hpp"
+#include "include/managed_stop_token.hpp"
+#include "include/task_buffer.hpp"
+#include "include/timer_wheel.hpp"
+
+namespace thp {
+
+//
+// timer_wheel driven by one thread (run), ticks of Static::timer_tick().
+// Due callbacks run on timer thread, so they should only hand work over,
+// e.g. push task to a run queue. Thread sleeps till the next tick which
+// fires or cascades something, or till an earlier timer is scheduled.
+//
+class timer_service {
+public:
+  using clock = std::chrono::steady_clock;
+  using tick_t = timer_wheel::tick_t;
+
+  explicit timer_service(clock::duration tick = Static::timer_tick())
+  : mu{}
+  , cv{}
+  , epoch{clock::now()}
+  , resolution{tick}
+  , wheel{0}
+  , wake_tick{never}
+  {}
+
+  timer_service(const timer_service&) = delete;
+  timer_service& operator = (const timer_service&) = delete;
+
+  timer_id schedule_at(clock::time_point tp, inplace_task&& fn) {
+    const auto t = ceil_tick(tp);
+    timer_id id;
+    bool earlier = false;
+    {
+      std::lock_guard l(mu);
+      id = wheel.insert(t, std::move(fn));
+      earlier = t < wake_tick;
+      if (earlier) wake_tick = t;
+    }
+    if (earlier) cv.notify_one();
+    return id;
+  }
+
+  template <typename Rep, typename Period>
+  timer_id schedule_after(std::chrono::duration<Rep, Period> d, inplace_task&& fn) {
+    return schedule_at(clock::now() + d, std::move(fn));
+  }
+
+  bool cancel(timer_id id) {
+    std::lock_guard l(mu);
+    return wheel.cancel(id);
+  }
+
+  std::size_t pending() const {
+    std::lock_guard l(mu);
+    return wheel.size();
+  }
+
+  // timer thread
+  void run(managed_stop_token st) {
+    task_buffer due;
+    while (!st.stop_requested()) {
+      {
+        std::unique_lock l(mu);
+        wheel.advance(floor_tick(clock::now()), due);
+        if (due.empty()) {
+          auto next = wheel.next_expiry();
+          wake_tick = next ? *next : never;
+          auto target = wake_tick;
+          auto rearmed = [&] { return wake_tick < target; };
+          if (next) cv.wait_until(l, st, epoch + static_cast<clock::rep>(target) * resolution, rearmed);
+          else      cv.wait(l, st, rearmed);
+          continue;
+        }
+        wake_tick = never;
+      }
+      for (; !due.empty(); due.pop_front()) due.front()();
+    }
+  }
+
+private:
+  static constexpr tick_t never = std::numeric_limits<tick_t>::max();
+
+  tick_t floor_tick(clock::time_point tp) const {
+    return tp <= epoch ? 0 : static_cast<tick_t>((tp - epoch) / resolution);
+  }
+
+  // never fires early
+  tick_t ceil_tick(clock::time_point tp) const {
+    if (tp <= epoch) return 0;
+    auto d = tp - epoch;
+    return static_cast<tick_t>((d + resolution - clock::duration(1)) / resolution);
+  }
+
+  mutable std::mutex mu;
+  std::condition_variable_any cv;
+  const clock::time_point epoch;
+  const clock::duration resolution;
+  timer_wheel wheel;
+  tick_t wake_tick;
+};
+
+} // namespace thp
+
+#endif // TIMER_SERVICE_HPP_
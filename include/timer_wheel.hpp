@@ -0,0 +1,261 @@
+#ifndef TIMER_WHEEL_HPP_
+#define TIMER_WHEEL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "include/inplace_task.hpp"
+#include "include/task_buffer.hpp"
+
+namespace thp {
+
+// handle of a pending timer, stale once timer fired or was cancelled
+struct timer_id {
+  std::uint32_t index = ~0u;
+  std::uint32_t gen = 0;
+
+  explicit operator bool() const { return index != ~0u; }
+};
+
+//
+// hierarchical hashed timing wheel (Varghese & Lauck), 4 levels of 256 slots
+// level l slot covers 256^l ticks, so 2^32 ticks are addressable; later
+// timers park in last level and are re-hashed when it comes around.
+//
+// Timers are nodes in chunked slab linked into slot lists by index, so
+// insert and cancel are O(1) and don't allocate once slab is warm. Timer
+// due in more than 256 ticks is cascaded down a level each time its slot
+// comes up, at most 3 times. Per level bitmaps let advance() and
+// next_expiry() skip straight to the next tick which fires or cascades.
+//
+// Not thread safe, see timer_service.
+//
+class timer_wheel {
+  static constexpr unsigned Bits = 8;
+  static constexpr unsigned Slots = 1u << Bits;
+  static constexpr unsigned Levels = 4;
+  static constexpr std::uint32_t npos = ~0u;
+  static constexpr unsigned ChunkBits = 12;
+
+  struct node {
+    inplace_task task;
+    std::uint64_t expiry;
+    std::uint32_t next;
+    std::uint32_t prev;
+    std::uint32_t gen;
+    std::uint16_t slot;   // level * Slots + index, valid when linked
+    bool linked;
+  };
+
+public:
+  using tick_t = std::uint64_t;
+
+  explicit timer_wheel(tick_t now = 0)
+  : now_{now}
+  , count{0}
+  , heads{}
+  , bitmap{}
+  , chunks{}
+  , free_head{npos}
+  {
+    heads.fill(npos);
+  }
+
+  timer_wheel(const timer_wheel&) = delete;
+  timer_wheel& operator = (const timer_wheel&) = delete;
+
+  tick_t now() const         { return now_; }
+  std::size_t size() const   { return count; }
+  bool empty() const         { return 0u == count; }
+
+  // task fires on first advance() reaching expiry, past expiry fires on next tick
+  timer_id insert(tick_t expiry, inplace_task&& t) {
+    auto i = alloc();
+    auto& n = at(i);
+    n.task = std::move(t);
+    n.expiry = std::max(expiry, now_ + 1);
+    link(i);
+    ++count;
+    return {i, n.gen};
+  }
+
+  // false if timer already fired or was cancelled
+  bool cancel(timer_id id) {
+    if (id.index >= chunks.size() << ChunkBits) return false;
+    auto& n = at(id.index);
+    if (!n.linked || n.gen != id.gen) return false;
+    unlink(id.index);
+    release(id.index);
+    --count;
+    return true;
+  }
+
+  // moves tasks due at or before tick `to` into out, in expiry order.
+  // Jumps straight between ticks which fire or cascade something.
+  void advance(tick_t to, task_buffer& out) {
+    while (now_ < to) {
+      const auto t = std::min(next_event(), to);
+      now_ = t;
+      if ((t & (Slots - 1)) == 0) cascade(t);
+      fire(t & (Slots - 1), out);
+    }
+  }
+
+  // earliest tick at which advance() has something to fire or cascade
+  std::optional<tick_t> next_expiry() const {
+    if (0u == count) return std::nullopt;
+    return next_event();
+  }
+
+  ~timer_wheel() = default;
+
+private:
+  node& at(std::uint32_t i) { return chunks[i >> ChunkBits][i & ((1u << ChunkBits) - 1)]; }
+
+  std::uint32_t alloc() {
+    if (free_head == npos) {
+      const auto base = static_cast<std::uint32_t>(chunks.size() << ChunkBits);
+      chunks.emplace_back(std::make_unique<node[]>(1u << ChunkBits));
+      auto& c = chunks.back();
+      for (std::uint32_t k = 0; k < (1u << ChunkBits); ++k) {
+        c[k].next = k + 1 < (1u << ChunkBits) ? base + k + 1 : npos;
+        c[k].gen = 0;
+        c[k].linked = false;
+      }
+      free_head = base;
+    }
+    auto i = free_head;
+    free_head = at(i).next;
+    return i;
+  }
+
+  void release(std::uint32_t i) {
+    auto& n = at(i);
+    n.task.reset();
+    n.linked = false;
+    ++n.gen;
+    n.next = free_head;
+    free_head = i;
+  }
+
+  // hash node into a slot relative to now_
+  void link(std::uint32_t i) {
+    auto& n = at(i);
+    const tick_t max_delta = (tick_t(1) << (Bits * Levels)) - 1;
+    const tick_t e = n.expiry - now_ > max_delta ? now_ + max_delta : n.expiry;
+    const tick_t delta = e - now_;
+    unsigned l = 0;
+    while (l + 1 < Levels && (delta >> (Bits * (l + 1))) != 0) ++l;
+    const auto s = static_cast<std::uint16_t>(l * Slots + ((e >> (Bits * l)) & (Slots - 1)));
+
+    n.slot = s;
+    n.linked = true;
+    n.prev = npos;
+    n.next = heads[s];
+    if (n.next != npos) at(n.next).prev = i;
+    heads[s] = i;
+    bitmap[s / 64] |= std::uint64_t{1} << (s % 64);
+  }
+
+  void unlink(std::uint32_t i) {
+    auto& n = at(i);
+    if (n.prev != npos) at(n.prev).next = n.next;
+    else                heads[n.slot] = n.next;
+    if (n.next != npos) at(n.next).prev = n.prev;
+    if (heads[n.slot] == npos) bitmap[n.slot / 64] &= ~(std::uint64_t{1} << (n.slot % 64));
+    n.linked = false;
+  }
+
+  // detaches whole slot list, returns its head
+  std::uint32_t take_slot(unsigned s) {
+    auto h = heads[s];
+    heads[s] = npos;
+    bitmap[s / 64] &= ~(std::uint64_t{1} << (s % 64));
+    return h;
+  }
+
+  // t is a multiple of Slots, re-hash upper level slots which came up
+  void cascade(tick_t t) {
+    for (unsigned l = 1; l < Levels; ++l) {
+      const auto idx = (t >> (Bits * l)) & (Slots - 1);
+      for (auto i = take_slot(l * Slots + idx); i != npos; ) {
+        auto next = at(i).next;
+        link(i);
+        i = next;
+      }
+      if (idx != 0) break;
+    }
+  }
+
+  void fire(unsigned idx, task_buffer& out) {
+    // slot list is LIFO, reverse to keep insertion order for equal expiry
+    std::uint32_t rev = npos;
+    for (auto i = take_slot(idx); i != npos; ) {
+      auto next = at(i).next;
+      at(i).next = rev;
+      rev = i;
+      i = next;
+    }
+    for (auto i = rev; i != npos; ) {
+      auto next = at(i).next;
+      out.push_back(std::move(at(i).task));
+      release(i);
+      --count;
+      i = next;
+    }
+  }
+
+  tick_t next_event() const {
+    tick_t best = std::numeric_limits<tick_t>::max();
+    // level 0 holds ticks now_+1 .. now_+255
+    const auto from0 = static_cast<unsigned>((now_ + 1) & (Slots - 1));
+    if (auto s = find_set_circular(0, from0))
+      best = now_ + 1 + ((*s - from0) & (Slots - 1));
+    // level l slot j cascades at start of the next block of 256^l ticks with index j
+    for (unsigned l = 1; l < Levels; ++l) {
+      const auto shift = Bits * l;
+      const tick_t base = (now_ >> shift) + 1;
+      const auto from = static_cast<unsigned>(base & (Slots - 1));
+      if (auto s = find_set_circular(l, from))
+        best = std::min(best, (base + ((*s - from) & (Slots - 1))) << shift);
+    }
+    return best;
+  }
+
+  std::optional<unsigned> find_set_circular(unsigned l, unsigned from) const {
+    if (auto s = find_set(l, from, Slots - 1)) return s;
+    if (from > 0) return find_set(l, 0, from - 1);
+    return std::nullopt;
+  }
+
+  // first non empty slot in [from, to] of level l
+  std::optional<unsigned> find_set(unsigned l, unsigned from, unsigned to) const {
+    for (unsigned s = l * Slots + from, e = l * Slots + to; s <= e; ) {
+      auto w = bitmap[s / 64] >> (s % 64);
+      if (w) {
+        auto r = s + std::countr_zero(w);
+        if (r <= e) return r - l * Slots;
+        return std::nullopt;
+      }
+      s = (s / 64 + 1) * 64;
+    }
+    return std::nullopt;
+  }
+
+  tick_t now_;
+  std::size_t count;
+  std::array<std::uint32_t, Levels * Slots> heads;
+  std::array<std::uint64_t, Levels * Slots / 64> bitmap;
+  std::vector<std::unique_ptr<node[]>> chunks;
+  std::uint32_t free_head;
+};
+
+} // namespace thp
+
+#endif // TIMER_WHEEL_HPP_
@@ -71,6 +71,18 @@ struct is_container : std::integral_constant<bool, is_vector<T...>::value> {};
 template<typename> struct is_tuple : std::false_type {};
 template<typename... T> struct is_tuple<std::tuple<T...>> : std::true_type {};
 
+// time_task and derived, released by timer service when due
+template <typename T>
+inline constexpr bool is_time_task_v = requires { typename T::TimePoint; };
+
+// time_series_task, re-armed on timer service point by point
+template <typename T>
+inline constexpr bool is_time_series_task_v = requires(T& t) { t.run_next(); };
+
+// Future is thp::future rather than std::future
+template<template<typename> class Future>
+inline constexpr bool is_thp_future_v = std::is_same_v<Future<int>, thp::future<int>>;
+
 #if 0
 template <typename T> struct is_simple_task : std::false_type{};
 template <typename T, typename P> struct is_priority_task : std::false_type{};
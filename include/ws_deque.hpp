@@ -0,0 +1,131 @@
+#ifndef WS_DEQUE_HPP_
+#define WS_DEQUE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+
+namespace thp {
+
+//
+// Chase-Lev work stealing deque (Le, Pop, Cohen, Nardelli: "Correct and
+// Efficient Work-Stealing for Weak Memory Models", PPoPP'13).
+// Owner thread pushes/pops at bottom (LIFO), thieves steal at top (FIFO).
+// T must be trivially copyable (e.g. raw task pointer), empty value is T{}.
+//
+template <typename T>
+requires std::is_trivially_copyable_v<T>
+class ws_deque {
+  struct ring {
+    explicit ring(std::int64_t cap)
+    : mask{cap - 1}
+    , slots{new std::atomic<T>[static_cast<std::size_t>(cap)]}
+    {}
+
+    std::int64_t capacity() const { return mask + 1; }
+    T load(std::int64_t i) const  { return slots[i & mask].load(std::memory_order::relaxed); }
+    void store(std::int64_t i, T v) { slots[i & mask].store(v, std::memory_order::relaxed); }
+
+    ring* grow(std::int64_t b, std::int64_t t) const {
+      auto r = new ring(2*capacity());
+      for (auto i = t; i < b; ++i) r->store(i, load(i));
+      return r;
+    }
+
+    const std::int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+public:
+  explicit ws_deque(std::int64_t capacity = 256)
+  : top{0}
+  , bottom{0}
+  , buf{new ring(capacity)}
+  , retired{}
+  {}
+
+  ws_deque(const ws_deque&) = delete;
+  ws_deque& operator = (const ws_deque&) = delete;
+
+  ~ws_deque() {
+    delete buf.load(std::memory_order::relaxed);
+  }
+
+  // owner only
+  void push(T v) {
+    auto b = bottom.load(std::memory_order::relaxed);
+    auto t = top.load(std::memory_order::acquire);
+    auto a = buf.load(std::memory_order::relaxed);
+    if (b - t > a->capacity() - 1) [[unlikely]] {
+      auto bigger = a->grow(b, t);
+      // thieves may still read from old ring, keep it alive till destruction
+      retired.emplace_back(a);
+      buf.store(bigger, std::memory_order::release);
+      a = bigger;
+    }
+    a->store(b, v);
+    std::atomic_thread_fence(std::memory_order::release);
+    bottom.store(b + 1, std::memory_order::relaxed);
+  }
+
+  // owner only, returns T{} when empty
+  T pop() {
+    auto b = bottom.load(std::memory_order::relaxed) - 1;
+    auto a = buf.load(std::memory_order::relaxed);
+    bottom.store(b, std::memory_order::relaxed);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    auto t = top.load(std::memory_order::relaxed);
+
+    T x{};
+    if (t <= b) {
+      x = a->load(b);
+      if (t == b) {
+        // last item, race against thieves
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order::seq_cst, std::memory_order::relaxed))
+          x = T{};
+        bottom.store(b + 1, std::memory_order::relaxed);
+      }
+    }
+    else {
+      bottom.store(b + 1, std::memory_order::relaxed);
+    }
+    return x;
+  }
+
+  // any thread, returns T{} when empty or lost the race
+  T steal() {
+    auto t = top.load(std::memory_order::acquire);
+    std::atomic_thread_fence(std::memory_order::seq_cst);
+    auto b = bottom.load(std::memory_order::acquire);
+
+    T x{};
+    if (t < b) {
+      auto a = buf.load(std::memory_order::consume);
+      x = a->load(t);
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order::seq_cst, std::memory_order::relaxed))
+        return T{};
+    }
+    return x;
+  }
+
+  std::size_t size() const {
+    auto b = bottom.load(std::memory_order::relaxed);
+    auto t = top.load(std::memory_order::relaxed);
+    return b > t ? static_cast<std::size_t>(b - t) : 0u;
+  }
+
+  bool empty() const { return 0u == size(); }
+
+private:
+  alignas(64) std::atomic<std::int64_t> top;
+  alignas(64) std::atomic<std::int64_t> bottom;
+  std::atomic<ring*> buf;
+  std::vector<std::unique_ptr<ring>> retired;
+};
+
+} // namespace thp
+
+#endif // WS_DEQUE_HPP_
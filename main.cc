@@ -38,12 +38,13 @@ void system_async(size_t n) {
   print_stats(vals);
 }
 
-void tp_enqueue(size_t n, size_t w) {
-  thp::threadpool tp(w);
+void tp_enqueue(size_t n, const thp::pool_config& cfg, microseconds gap = {}) {
+  thp::threadpool tp(cfg);
   std::vector<std::future<long int>> vals;
   vals.reserve(n);
 
   for(int i = 0; i < n; ++i) {
+    if (gap.count()) std::this_thread::sleep_for(gap);
     auto x = steady_clock::now();
     auto [f] = tp.schedule(thp::make_task([x] { auto y = steady_clock::now(); return duration_cast<microseconds>(y-x).count(); }));
     vals.emplace_back(std::move(f));
@@ -72,9 +73,11 @@ int main(int argc, const char* const argv[])
   spdlog::info("hello from threadpool");
   auto n = argc > 1 ? stoi(argv[1]) : 10000;
   auto w = argc > 2 ? stoi(argv[2]) : 16;
+  bool direct = argc > 3 && argv[3] == "direct"s;
+  auto gap = microseconds(argc > 4 ? stoi(argv[4]) : 0);
 
 //  tp_schedule(n, w);
-  tp_enqueue(n, w);
+  tp_enqueue(n, thp::pool_config{.max_threads = static_cast<unsigned>(w), .direct_dispatch = direct}, gap);
 //  system_async(n);
 
   return 0;
@@ -1,31 +1,120 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <memory>
 #include <thread>
 #include <shared_mutex>
 #include <mutex>
 
+#include "include/configuration.hpp"
 #include "include/worker_pool.hpp"
 #include "include/scheduler.hpp"
 #include "include/algos/scheduling/schedule_algos.hpp"
 #include "include/algos/scheduling/maxlen.hpp"
 #include "include/algos/scheduling/first_available.hpp"
 #include "include/algos/scheduling/fair_share.hpp"
+#include "include/algos/scheduling/edf.hpp"
+#include "include/algos/scheduling/auto_select.hpp"
 
 namespace thp {
-task_scheduler::task_scheduler()
+task_scheduler::task_scheduler(sched_algos::names initial)
   : all_algos{}
   , algo{nullptr}
+  , worker_algo{nullptr}
+  , name{sched_algos::names::eInvalid}
+  , batch_shift{0}
   {
     all_algos[sched_algos::names::eFirstAvailable].reset(new sched_algos::first_avail_algo());
     all_algos[sched_algos::names::eMaxLen].reset(new sched_algos::maxlen_algo());
     all_algos[sched_algos::names::eFairShare].reset(new sched_algos::fairshare_algo());
-    algo = all_algos[sched_algos::names::eFairShare];
+    all_algos[sched_algos::names::eEdf].reset(new sched_algos::edf_algo());
+    all_algos[sched_algos::names::eAuto].reset(new sched_algos::auto_algo({
+      {sched_algos::names::eFairShare, all_algos[sched_algos::names::eFairShare]},
+      {sched_algos::names::eEdf, all_algos[sched_algos::names::eEdf]},
+      {sched_algos::names::eMaxLen, all_algos[sched_algos::names::eMaxLen]},
+      {sched_algos::names::eFirstAvailable, all_algos[sched_algos::names::eFirstAvailable]},
+    }));
+    update_algorithm(initial);
   }
 
+// map is never modified after construction, so lookup needs no lock
+void task_scheduler::update_algorithm(sched_algos::names new_algo) {
+  auto a = all_algos.at(new_algo);
+  worker_algo.store(a.get(), std::memory_order::release);
+  algo.store(std::move(a));
+  name.store(new_algo);
+}
+
+sched_algos::names task_scheduler::algorithm() const {
+  return name.load();
+}
+
+void task_scheduler::install(const std::vector<task_queue*>& qs) {
+  for (auto& [n, a] : all_algos) a->install(qs);
+}
+
+//
+// sizes next tick from live measurements
+//
+// A batch holds about Static::batch_target() of work per worker, so cheap
+// tasks move in large batches which amortize the handoff, and long tasks in
+// small ones which keep them spread over workers. On top of that estimate
+// sits a power of two scale kept across ticks. Idle workers while tasks
+// are queued mean scheduler can't keep up, scale goes up and it doesn't
+// linger. Tasks waiting in output much longer than target mean batch is too
+// big for latency, scale goes down. Other ticks keep the scale, so it adds
+// up over consecutive overloaded (or underloaded) ticks and follows changes
+// of run time through the estimate. With nobody idle scheduler lingers up
+// to one task run time (Static::scheduler_tick() .. max_sched_linger()) for
+// a partial batch to fill. Until first run time sample everything queued
+// moves at once.
+//
 void task_scheduler::compute_stats(statistics& stats) {
+  using namespace std::chrono;
+  auto& s = stats.sched;
+  // moving average, 1/8 weight to new sample
+  auto smooth = [](nanoseconds avg, nanoseconds sample) {
+    if (sample.count() == 0) return avg;
+    if (avg.count() == 0)    return sample;
+    return avg + (sample - avg) / 8;
+  };
+  s.exec_time = smooth(s.exec_time, s.exec_sample);
+  s.wait_time = smooth(s.wait_time, s.wait_sample);
+
+  const auto workers = std::max<std::size_t>(1u, stats.pool.num_workers);
+  if (s.exec_time.count() == 0) {
+    stats.jobq.in.load_factor = -1;
+    s.batch = stats.jobq.in.num_tasks;
+    s.linger = nanoseconds(0);
+    batch_shift = 0;
+    return;
+  }
+
+  const nanoseconds target = Static::batch_target();
+  const auto max_lf = static_cast<long>(Static::max_load_factor());
+  const auto base = std::clamp<long>(target / s.exec_time, 1, max_lf);
+  const bool starving = s.idle_workers > 0 && stats.jobq.in.num_tasks > 0;
+  if (starving)                      ++batch_shift;
+  else if (s.wait_time > 2 * target) --batch_shift;
+  // scaled batch stays within [1, max_load_factor()], scale doesn't wind up
+  const auto lo = 1 - static_cast<int>(std::bit_width(static_cast<unsigned long>(base)));
+  const auto hi = static_cast<int>(std::bit_width(static_cast<unsigned long>(max_lf / base))) - 1;
+  batch_shift = std::clamp(batch_shift, lo, hi);
+  const auto lf = batch_shift >= 0 ? base << batch_shift : base >> -batch_shift;
+
+  stats.jobq.in.load_factor = static_cast<int>(lf);
+  s.batch = static_cast<std::size_t>(lf) * workers;
+  s.linger = s.idle_workers > 0
+               ? nanoseconds(0)
+               : std::clamp<nanoseconds>(s.exec_time, Static::scheduler_tick(), Static::max_sched_linger());
 }
 
 void task_scheduler::apply(statistics& stats) {
-  algo->apply(stats);
+  algo.load()->apply(stats);
+}
+
+int task_scheduler::reschedule_worker(statistics& stats, std::thread::id tid) {
+  return worker_algo.load(std::memory_order::acquire)->apply(stats, tid);
 }
 
 #if 0
@@ -40,10 +129,6 @@ void task_scheduler::reschedule(std::thread_id id) {
 
 
 
-void task_scheduler::reschedule_worker(const statistics& stats, std::thread::id tid) {
-  //return algo_->apply(stats, tid);
-}
-
 bool task_scheduler::reschedule(const statistics& stats) {
   auto ret = algo_->ok(stats);
   if (!ret)
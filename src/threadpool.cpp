@@ -14,18 +14,24 @@
 namespace thp {
 
 threadpool::threadpool(unsigned max_threads)
+  : threadpool(pool_config{.max_threads = max_threads})
+{}
+
+threadpool::threadpool(const pool_config& cfg)
   : mu_{}
   , shutdown_cv_{}
-  , jobq_{}
+  , jobq_{cfg}
   , worker_pool_{}
   , managers_{}
   , book_keepers_{}
-  , max_threads_{max_threads}
+  , max_threads_{cfg.max_threads}
+  , on_exception_{}
 {
   std::lock_guard<std::mutex> lck(mu_);
   worker_pool_.start_n_thread(max_threads_, &job_queue<TaskQueueTupleType>::worker_fn, &jobq_);
 
   managers_.start_thread(&job_queue<TaskQueueTupleType>::schedule_fn, &jobq_);
+  managers_.start_thread(&job_queue<TaskQueueTupleType>::timer_fn, &jobq_);
   //book_keepers_.start_thread(&threadpool::print, this, std::ref(std::cerr));
 }
 
@@ -69,6 +75,26 @@ void threadpool::print(std::ostream& oss, managed_stop_token st) {
   }
 }
 
+void threadpool::set_exception_handler(exception_handler fn) {
+  on_exception_.store(fn ? std::make_shared<const exception_handler>(std::move(fn)) : nullptr);
+}
+
+void threadpool::handle_exception(std::exception_ptr ex) noexcept {
+  try {
+    if (auto fn = on_exception_.load()) {
+      (*fn)(ex);
+      return;
+    }
+    std::rethrow_exception(ex);
+  }
+  catch(std::exception& e) {
+    std::cerr << "threadpool: uncaught exception in posted task: " << e.what() << std::endl;
+  }
+  catch(...) {
+    std::cerr << "threadpool: uncaught exception in posted task" << std::endl;
+  }
+}
+
 //void threadpool::drain() { jobq_.drain(); }
 
 void threadpool::shutdown() {
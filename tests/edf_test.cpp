@@ -0,0 +1,116 @@
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/algos/scheduling/edf.hpp"
+#include "include/all_priority_types.hpp"
+#include "include/threadpool.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+thp::deadline_task<void> make_task(std::string& order, char c, thp::deadline d) {
+  thp::deadline_task<void> t([&order, c] { order += c; });
+  t.set_priority(std::move(d));
+  return t;
+}
+
+// on time deadline tasks by deadline, then other queues, then demoted ones
+TEST(EdfTest, dispatch_order) {
+  std::string order;
+  thp::mpmc_taskq fifo;
+  thp::deadline_taskq dq;
+  dq.set_policy(thp::deadline_policy::eDemote);
+
+  for (int i = 0; i < 3; ++i) fifo.put(thp::inplace_task([&] { order += 'f'; }));
+  dq.put(make_task(order, 'c', thp::deadline::after(30s)));
+  dq.put(make_task(order, 'a', thp::deadline::after(10s)));
+  dq.put(make_task(order, 'x', thp::deadline{thp::deadline::clock::now() - 1ms}));
+  dq.put(make_task(order, 'b', thp::deadline::after(20s)));
+
+  std::vector<thp::task_queue*> qs{&fifo, &dq};
+  const std::vector<unsigned> weights{1, 1};
+  thp::task_buffer out;
+  thp::statistics stats{std::chrono::system_clock::now(), {{qs, 0u, -1, weights}, {&out, 0}}, {2, 2}};
+  thp::sched_algos::edf_algo algo;
+  algo.install(qs);
+
+  algo.apply(stats);
+  EXPECT_EQ(7u, stats.jobq.out.new_tasks);
+  for (; !out.empty(); out.pop_front()) out.front()();
+  EXPECT_EQ("abcfffx", order);
+
+  auto s = dq.stats();
+  EXPECT_EQ(1u, s.demoted);
+  EXPECT_EQ(3u, s.met);
+  EXPECT_EQ(1u, s.missed);
+  EXPECT_EQ(0u, s.dropped);
+}
+
+TEST(EdfTest, drop_missed) {
+  std::string order;
+  thp::deadline_taskq dq;
+  dq.set_policy(thp::deadline_policy::eDrop);
+
+  thp::deadline_task<void> late([&] { order += 'x'; });
+  late.set_priority(thp::deadline{thp::deadline::clock::now() - 1ms});
+  auto f = late.future();
+  dq.put(std::move(late));
+  dq.put(make_task(order, 'a', thp::deadline::after(10s)));
+
+  thp::task_buffer out;
+  EXPECT_EQ(1u, dq.pop_n(out, 2));
+  EXPECT_EQ(0u, dq.len());
+  for (; !out.empty(); out.pop_front()) out.front()();
+  EXPECT_EQ("a", order);
+  EXPECT_THROW(f.get(), std::future_error);
+  EXPECT_EQ(1u, dq.stats().dropped);
+}
+
+// not yet past its deadline, but won't finish by it
+TEST(EdfTest, demote_infeasible) {
+  std::string order;
+  thp::deadline_taskq dq;
+  dq.set_policy(thp::deadline_policy::eDemote);
+
+  dq.put(make_task(order, 'x', thp::deadline::after(1s, 5s)));
+  dq.put(make_task(order, 'a', thp::deadline::after(2s, 1ms)));
+  dq.put(make_task(order, 'b', thp::deadline::after(3s)));
+
+  thp::task_buffer out;
+  EXPECT_EQ(2u, dq.pop_on_time(out, 3));
+  EXPECT_EQ(1u, dq.stats().demoted);
+
+  // own hint wins over the queue estimate
+  dq.put(make_task(order, 'c', thp::deadline::after(4s, 1ms)));
+  dq.put(make_task(order, 'y', thp::deadline::after(5s)));
+  dq.set_run_estimate(10s);
+  EXPECT_EQ(1u, dq.pop_on_time(out, 2));
+  EXPECT_EQ(2u, dq.stats().demoted);
+
+  EXPECT_EQ(2u, dq.pop_late(out, 2));
+  for (; !out.empty(); out.pop_front()) out.front()();
+  EXPECT_EQ("abcxy", order);
+}
+
+TEST(EdfTest, pool_counts_deadlines) {
+  thp::threadpool tp(2);
+  tp.set_deadline_policy(thp::deadline_policy::eDrop);
+  std::vector<std::future<int>> fs;
+  for (int i = 0; i < 8; ++i) {
+    thp::deadline_task<int> t([i] { return i; });
+    t.set_priority(thp::deadline::after(10s));
+    auto [f] = tp.schedule(std::move(t));
+    fs.emplace_back(std::move(f));
+  }
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(i, fs[i].get());
+  tp.shutdown();
+  auto s = tp.deadlines();
+  EXPECT_EQ(8u, s.met + s.missed);
+  EXPECT_EQ(0u, s.dropped);
+}
+
+} // namespace
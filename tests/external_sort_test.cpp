@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/external_sort.hpp"
+
+namespace {
+
+struct record {
+  std::uint64_t key;
+  std::uint32_t seq;
+  std::uint32_t pad;
+};
+
+struct ExternalSortTest : ::testing::Test {
+  void SetUp() override {
+    dir = std::filesystem::temp_directory_path() / ("thp_ext_test_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+  }
+  void TearDown() override { std::filesystem::remove_all(dir); }
+
+  template <typename T>
+  void write(const std::filesystem::path& p, const std::vector<T>& v) {
+    std::ofstream f(p, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+  }
+
+  template <typename T>
+  std::vector<T> read(const std::filesystem::path& p) {
+    std::vector<T> v(std::filesystem::file_size(p) / sizeof(T));
+    std::ifstream f(p, std::ios::binary);
+    f.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(T));
+    return v;
+  }
+
+  std::filesystem::path dir;
+};
+
+// small budget forces many runs and a real merge
+TEST_F(ExternalSortTest, many_runs) {
+  thp::threadpool tp(4);
+  std::mt19937_64 rng(1);
+  std::vector<record> in(200000);
+  for (std::uint32_t i = 0; i < in.size(); ++i) in[i] = {rng() % 50000, i, 0};
+  write(dir / "in", in);
+
+  thp::external_sort_config cfg{.temp_dir = dir, .memory_budget = 256u << 10, .io_block = 16u << 10, .merge_parts = 3};
+  thp::external_sorter<record, std::ranges::less, decltype(&record::key)> sorter(tp, cfg, {}, &record::key);
+  auto stats = sorter.sort(dir / "in", dir / "out");
+  EXPECT_EQ(in.size(), stats.records);
+  EXPECT_GT(stats.runs, 10u);
+
+  auto out = read<record>(dir / "out");
+  ASSERT_EQ(in.size(), out.size());
+  std::vector<bool> seen(in.size());
+  for (std::size_t i = 0; i < out.size(); ++i) {
+    if (i > 0) {
+      ASSERT_LE(out[i - 1].key, out[i].key);
+    }
+    ASSERT_EQ(in[out[i].seq].key, out[i].key);
+    seen[out[i].seq] = true;
+  }
+  EXPECT_EQ(in.size(), std::size_t(std::count(seen.begin(), seen.end(), true)));
+  // temp runs are gone
+  EXPECT_EQ(2, std::distance(std::filesystem::directory_iterator(dir), {}));
+  tp.shutdown();
+}
+
+TEST_F(ExternalSortTest, single_run_and_edge_cases) {
+  thp::threadpool tp(2);
+  std::vector<double> in{3.5, -1.0, 2.25, 0.0, -7.5};
+  write(dir / "in", in);
+  thp::external_sorter<double, std::ranges::greater> sorter(tp, {.temp_dir = dir});
+  EXPECT_EQ(1u, sorter.sort(dir / "in", dir / "out").runs);
+  EXPECT_EQ((std::vector<double>{3.5, 2.25, 0.0, -1.0, -7.5}), read<double>(dir / "out"));
+
+  write(dir / "empty", std::vector<double>{});
+  EXPECT_EQ(0u, sorter.sort(dir / "empty", dir / "out").records);
+  EXPECT_EQ(0u, std::filesystem::file_size(dir / "out"));
+
+  write(dir / "odd", std::vector<char>(12));
+  EXPECT_THROW(sorter.sort(dir / "odd", dir / "out"), std::invalid_argument);
+  EXPECT_THROW(sorter.sort(dir / "missing", dir / "out"), std::system_error);
+
+  // sorting a file onto itself is refused before it is truncated
+  EXPECT_THROW(sorter.sort(dir / "in", dir / "." / "in"), std::invalid_argument);
+  EXPECT_EQ(in, read<double>(dir / "in"));
+  tp.shutdown();
+}
+
+} // namespace
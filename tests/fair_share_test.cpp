@@ -0,0 +1,85 @@
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/algos/scheduling/fair_share.hpp"
+#include "include/all_priority_types.hpp"
+#include "include/task_factory.hpp"
+#include "include/threadpool.hpp"
+
+namespace {
+
+// weights 1:1:3, mpmc has a short backlog, others a long one
+TEST(FairShareTest, bounded_unfairness) {
+  std::string order;
+  thp::mpmc_taskq c;
+  thp::priority_taskq<int> a;
+  thp::bucket_taskq<thp::level> b;
+  for (int i = 0; i < 10; ++i) c.put(thp::inplace_task([&] { order += 'c'; }));
+  for (int i = 0; i < 1000; ++i) {
+    thp::priority_task<void, int> t([&] { order += 'a'; });
+    t.set_priority(int(i % 7));
+    a.put(std::move(t));
+  }
+  for (int i = 0; i < 300; ++i) {
+    thp::priority_task<void, thp::level> t([&] { order += 'b'; });
+    t.set_priority(thp::level::eNormal);
+    b.put(std::move(t));
+  }
+
+  std::vector<thp::task_queue*> qs{&c, &a, &b};
+  const std::vector<unsigned> weights{1, 1, 3};
+  thp::task_buffer out;
+  thp::statistics stats{std::chrono::system_clock::now(), {{qs, 0u, 2, weights}, {&out, 0}}, {4, 4}};
+  thp::sched_algos::fairshare_algo algo;
+
+  std::size_t total = 0;
+  for (int tick = 0; tick < 10000 && !(a.empty() && b.empty() && c.empty()); ++tick) {
+    stats.jobq.out.reset();
+    algo.apply(stats);
+    EXPECT_LE(stats.jobq.out.new_tasks, 8u); // load_factor * num_workers
+    total += stats.jobq.out.new_tasks;
+    for (; !out.empty(); out.pop_front()) out.front()();
+  }
+  ASSERT_EQ(1310u, total);
+  ASSERT_EQ(1310u, order.size());
+
+  // short backlog isn't stuck behind long ones, 10 rounds of 5
+  EXPECT_LT(order.rfind('c'), 50u);
+
+  // while a and b are both busy, b gets 3 tasks per a task, +- one round
+  long na = 0, nb = 0;
+  for (auto ch : order) {
+    na += ch == 'a';
+    nb += ch == 'b';
+    if (nb == 300) break;
+    EXPECT_LE(std::labs(nb - 3*na), 5) << "after a=" << na << " b=" << nb;
+  }
+}
+
+TEST(FairShareTest, all_priority_types) {
+  using namespace std::chrono;
+  thp::threadpool tp(2);
+  tp.set_weight<thp::level>(4);
+
+  auto t1 = thp::make_task<int>([] { return 1; });
+  auto t2 = thp::make_task<thp::level>([] { return 2; });
+  auto t3 = thp::make_task<float>([] { return 3; });
+  auto t4 = thp::make_task<steady_clock::time_point>([] { return 4; });
+  auto t5 = thp::make_task<system_clock::time_point>([] { return 5; });
+  auto t6 = thp::make_task([] { return 6; });
+  t1.set_priority(1);
+  t2.set_priority(thp::level::eHigh);
+  t3.set_priority(0.5f);
+  t4.set_priority(steady_clock::now());
+  t5.set_priority(system_clock::now());
+
+  auto [f1, f2, f3, f4, f5, f6] = tp.schedule(std::move(t1), std::move(t2), std::move(t3),
+                                              std::move(t4), std::move(t5), std::move(t6));
+  EXPECT_EQ(21, f1.get() + f2.get() + f3.get() + f4.get() + f5.get() + f6.get());
+  tp.shutdown();
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <string>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/future.hpp"
+#include "include/threadpool.hpp"
+
+namespace {
+
+TEST(FutureTest, value_and_exception) {
+  thp::promise<int> p1;
+  auto f1 = p1.get_future();
+  EXPECT_FALSE(f1.is_ready());
+  p1.set_value(42);
+  EXPECT_TRUE(f1.is_ready());
+  EXPECT_EQ(42, f1.get());
+  EXPECT_FALSE(f1.valid());
+  EXPECT_THROW(p1.set_value(7), thp::future_error_ex);
+
+  thp::promise<void> p2;
+  auto f2 = p2.get_future();
+  p2.set_exception(std::make_exception_ptr(std::runtime_error("boom")));
+  EXPECT_THROW(f2.get(), std::runtime_error);
+
+  thp::future<int> f3;
+  {
+    thp::promise<int> p3;
+    f3 = p3.get_future();
+  }
+  EXPECT_THROW(f3.get(), std::future_error);
+}
+
+TEST(FutureTest, wait_across_threads) {
+  thp::promise<std::string> p;
+  auto f = p.get_future();
+  std::thread th([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    p.set_value("done");
+  });
+  EXPECT_EQ(std::future_status::timeout, f.wait_for(std::chrono::microseconds(10)));
+  EXPECT_EQ(std::future_status::ready, f.wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ("done", f.get());
+  th.join();
+}
+
+TEST(FutureTest, then) {
+  // attached before completion
+  thp::promise<int> p;
+  auto f = p.get_future()
+             .then([](int x) { return x + 1; })
+             .then([](int x) { return std::to_string(x); });
+  p.set_value(1);
+  EXPECT_EQ("2", f.get());
+
+  // attached after completion
+  thp::promise<int> q;
+  auto g = q.get_future();
+  q.set_value(7);
+  EXPECT_EQ(14, std::move(g).then([](int x) { return 2*x; }).get());
+
+  // exception skips continuation
+  thp::promise<int> r;
+  bool called = false;
+  auto h = r.get_future().then([&](int) { called = true; });
+  r.set_exception(std::make_exception_ptr(std::logic_error("x")));
+  EXPECT_THROW(h.get(), std::logic_error);
+  EXPECT_FALSE(called);
+}
+
+TEST(FutureTest, threadpool) {
+  thp::threadpool tp(2);
+  auto f = tp.async([](int a, int b) { return a*b; }, 6, 7);
+  EXPECT_EQ(42, f.get());
+
+  auto t = thp::make_task([] { return 5; });
+  auto [g] = tp.schedule<thp::future>(t);
+  EXPECT_EQ(5, g.get());
+  tp.shutdown();
+}
+
+// one kind of future per task, misuse throws at the caller
+TEST(FutureTest, task_single_future) {
+  thp::simple_task<int> a([] { return 1; });
+  auto fa = a.future();
+  EXPECT_THROW(a.lite_future(), std::future_error);
+  a.execute();
+  EXPECT_EQ(1, fa.get());
+
+  thp::simple_task<int> b([] { return 2; });
+  auto fb = b.lite_future();
+  EXPECT_THROW(b.future(), std::future_error);
+  b.execute();
+  EXPECT_EQ(2, fb.get());
+
+  thp::simple_task<int> c([]() -> int { throw std::runtime_error("c"); });
+  auto fc = c.lite_future();
+  c.execute();
+  EXPECT_THROW(fc.get(), std::runtime_error);
+}
+
+TEST(FutureTest, chain) {
+  thp::threadpool tp(2);
+  auto f = tp.chain([] { return std::make_unique<int>(3); },
+                    [](std::unique_ptr<int> p) { *p += 1; return p; },
+                    [](std::unique_ptr<int> p) { return std::to_string(*p); });
+  EXPECT_EQ("4", f.get());
+
+  // void stage, continuing a future
+  std::atomic<int> seen{0};
+  auto g = tp.chain(tp.async([] { return 2; }), [&](int x) { seen = x; }, [&] { return seen * 10; });
+  EXPECT_EQ(20, g.get());
+
+  // exception skips the rest
+  bool called = false;
+  auto h = tp.chain([]() -> int { throw std::logic_error("x"); }, [&](int) { called = true; });
+  EXPECT_THROW(h.get(), std::logic_error);
+  EXPECT_FALSE(called);
+  tp.shutdown();
+}
+
+// stages waiting on a result hold no worker, so a single worker pool keeps
+// running other tasks, including the one which produces it
+TEST(FutureTest, chain_holds_no_worker) {
+  thp::threadpool tp(1);
+  std::vector<thp::future<int>> fs;
+  std::vector<thp::promise<int>> ps(64);
+  for (auto& p : ps) fs.emplace_back(tp.chain(p.get_future(), [](int x) { return x + 1; }));
+  for (int i = 0; i < 64; ++i) tp.post([&ps, i] { ps[i].set_value(i); });
+  for (int i = 0; i < 64; ++i) EXPECT_EQ(i + 1, fs[i].get());
+  tp.shutdown();
+}
+
+} // namespace
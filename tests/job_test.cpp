@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/threadpool.hpp"
+
+namespace {
+
+std::vector<thp::simple_task<int>> make_tasks(int n) {
+  std::vector<thp::simple_task<int>> tasks;
+  for (int i = 0; i < n; ++i) tasks.emplace_back([i] { return i * i; });
+  return tasks;
+}
+
+TEST(JobTest, runs_on_pool) {
+  thp::threadpool tp(4);
+  for (int round = 0; round < 50; ++round) {
+    auto work = thp::job<thp::simple_task<int>>(make_tasks(100)).num_workers(3);
+    auto futs = tp.run(work);
+    ASSERT_EQ(100u, futs.size());
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(i * i, futs[i].get());
+  }
+  tp.shutdown();
+}
+
+TEST(JobTest, num_workers_caps_concurrency) {
+  thp::threadpool tp(4);
+  std::atomic<int> running{0}, peak{0};
+  std::vector<thp::simple_task<void>> tasks;
+  for (int i = 0; i < 40; ++i) {
+    tasks.emplace_back([&] {
+      auto r = ++running;
+      for (auto p = peak.load(); r > p && !peak.compare_exchange_weak(p, r); ) {}
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      --running;
+    });
+  }
+  auto work = thp::job<thp::simple_task<void>>(std::move(tasks)).num_workers(2);
+  tp.run(work);
+  EXPECT_LE(peak.load(), 2);
+  tp.shutdown();
+}
+
+// job run from inside a task on a single worker pool, caller does the work
+TEST(JobTest, nested_run_on_one_worker) {
+  thp::threadpool tp(1);
+  auto [f] = tp.enqueue([&tp] {
+    auto work = thp::job<thp::simple_task<int>>(make_tasks(10));
+    auto futs = tp.run(work);
+    int sum = 0;
+    for (auto& x : futs) sum += x.get();
+    return sum;
+  });
+  EXPECT_EQ(285, f.get());
+  tp.shutdown();
+}
+
+TEST(JobTest, loop_schedules) {
+  using enum thp::loop_schedule;
+  thp::threadpool tp(4);
+  const std::pair<thp::loop_schedule, std::size_t> modes[] = {
+    {eStatic, 0}, {eStatic, 3}, {eDynamic, 0}, {eDynamic, 7}, {eGuided, 0}, {eGuided, 4},
+  };
+  for (auto [mode, chunk] : modes) {
+    for (int n : {0, 1, 5, 97, 1000}) {
+      std::vector<std::atomic<int>> hits(n);
+      std::vector<thp::simple_task<void>> tasks;
+      for (int i = 0; i < n; ++i) tasks.emplace_back([&hits, i] { hits[i]++; });
+      auto work = thp::job<thp::simple_task<void>>(std::move(tasks)).schedule(mode, chunk);
+      tp.run(work);
+      for (int i = 0; i < n; ++i) ASSERT_EQ(1, hits[i].load()) << int(mode) << " " << chunk << " " << n;
+    }
+  }
+  tp.shutdown();
+}
+
+// same job object run again: fresh claims and fresh results every time
+TEST(JobTest, run_same_job_twice) {
+  using enum thp::loop_schedule;
+  thp::threadpool tp(4);
+  for (auto mode : {eStatic, eDynamic, eGuided}) {
+    std::vector<std::atomic<int>> hits(200);
+    std::vector<thp::simple_task<int>> tasks;
+    for (int i = 0; i < 200; ++i) tasks.emplace_back([&hits, i] { hits[i]++; return i; });
+    auto work = thp::job<thp::simple_task<int>>(std::move(tasks)).num_workers(3).schedule(mode);
+
+    auto first = tp.run(work);
+    auto second = tp.run<thp::future>(work);
+    for (int i = 0; i < 200; ++i) {
+      ASSERT_EQ(2, hits[i].load()) << int(mode) << " " << i;
+      EXPECT_EQ(i, first[i].get());
+      EXPECT_EQ(i, second[i].get());
+    }
+  }
+  tp.shutdown();
+}
+
+// every worker waits on tasks queued behind it, waiting worker runs them
+TEST(JobTest, wait_helps_nested_tasks) {
+  for (auto mode : {thp::dispatch_mode::eShared, thp::dispatch_mode::eWorkStealing, thp::dispatch_mode::eDecentralized}) {
+    thp::threadpool tp(thp::pool_config{.max_threads = 2, .dispatch = mode});
+    std::vector<std::future<int>> outer;
+    for (int i = 0; i < 8; ++i) {
+      auto [f] = tp.enqueue([&tp, i] {
+        std::vector<std::future<int>> inner;
+        for (int j = 0; j < 16; ++j) {
+          auto [g] = tp.enqueue([i, j] { return i + j; });
+          inner.emplace_back(std::move(g));
+        }
+        int sum = 0;
+        for (auto& g : inner) sum += tp.get(g);
+        return sum;
+      });
+      outer.emplace_back(std::move(f));
+    }
+    for (int i = 0; i < 8; ++i) EXPECT_EQ(16 * i + 120, tp.get(outer[i]));
+    tp.shutdown();
+  }
+}
+
+} // namespace
@@ -0,0 +1,68 @@
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/threadpool.hpp"
+
+namespace {
+
+template <typename Pred>
+void wait_until(Pred&& done) {
+  while (!done()) std::this_thread::yield();
+}
+
+TEST(PostTest, post_and_exception_handler) {
+  using enum thp::wait_strategy;
+  using enum thp::dispatch_mode;
+  const thp::pool_config configs[] = {
+    {.max_threads = 2},
+    {.max_threads = 2, .direct_dispatch = true},
+    {.max_threads = 2, .wait = ePark},
+    {.max_threads = 2, .direct_dispatch = true, .wait = eSpinPark},
+    {.max_threads = 2, .wait = eBusyPoll},
+    {.max_threads = 2, .dispatch = eWorkStealing, .wait = eSpinPark},
+    {.max_threads = 2, .dispatch = eWorkStealing, .wait = eBusyPoll},
+    {.max_threads = 2, .dispatch = eDecentralized},
+    {.max_threads = 2, .dispatch = eDecentralized, .wait = eSpinPark},
+  };
+  for (const auto& cfg : configs) {
+    thp::threadpool tp(cfg);
+    std::atomic<int> sum{0}, errors{0};
+    tp.set_exception_handler([&](std::exception_ptr ex) {
+      EXPECT_THROW(std::rethrow_exception(ex), std::runtime_error);
+      errors++;
+    });
+
+    for (int i = 1; i <= 100; ++i)
+      tp.post([&sum](int x) { sum += x; }, i);
+    tp.post([] { throw std::runtime_error("boom"); });
+
+    wait_until([&] { return sum.load() == 5050 && errors.load() == 1; });
+    tp.shutdown();
+  }
+}
+
+TEST(PostTest, post_bulk) {
+  thp::threadpool tp(2);
+  std::atomic<int> count{0};
+  std::vector<std::function<void()>> fns(1000, [&count] { count++; });
+  tp.post_bulk(fns);
+  tp.post_bulk(std::move(fns));
+  wait_until([&] { return count.load() == 2000; });
+
+  // bulk from inside a worker goes to its local queue
+  thp::threadpool ws(thp::pool_config{.max_threads = 2, .dispatch = thp::dispatch_mode::eWorkStealing});
+  std::atomic<int> inner{0};
+  ws.post([&] {
+    std::vector<std::function<void()>> v(100, [&inner] { inner++; });
+    ws.post_bulk(v);
+  });
+  wait_until([&] { return inner.load() == 100; });
+  ws.shutdown();
+  tp.shutdown();
+}
+
+} // namespace
@@ -48,20 +48,20 @@ TEST(PriorityTaskTest, qorder) {
   auto t1 = thp::make_task<int>(factorial, 1);
   auto t2 = thp::make_task<int>(factorial, 2);
   auto t3 = thp::make_task<int>(factorial, 3);
-  auto f1 = t1->future(); 
-  auto f2 = t2->future(); 
-  auto f3 = t3->future(); 
-  t1->set_priority(1);
-  t2->set_priority(2);
-  t3->set_priority(3);
+  auto f1 = t1.future(); 
+  auto f2 = t2.future(); 
+  auto f3 = t3.future(); 
+  t1.set_priority(1);
+  t2.set_priority(2);
+  t3.set_priority(3);
 
   thp::priority_taskq<int> q;
   q.put(std::move(t3));
   q.put(std::move(t1));
   q.put(std::move(t2));
-  std::shared_ptr<thp::executable> t;
+  thp::inplace_task t;
   q.pop(t);
-  t->execute();
+  t();
   EXPECT_TRUE(f3.valid());
   EXPECT_EQ(6, f3.get());
 }
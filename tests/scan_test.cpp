@@ -0,0 +1,55 @@
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/threadpool.hpp"
+
+namespace {
+
+TEST(ScanTest, inclusive_exclusive_transform) {
+  thp::threadpool tp(4);
+  for (std::size_t n : {1u, 7u, 1000u, 100003u}) {
+    std::vector<long> data(n);
+    std::iota(data.begin(), data.end(), -50);
+    std::vector<long> out(n), expect(n);
+    const auto parts = std::min<std::size_t>(n, 13);
+
+    auto [f1] = tp.inclusive_scan(data.begin(), data.end(), out.begin(), std::plus<>{},
+                                  thp::partition::EqualSize(data.begin(), data.end(), parts));
+    EXPECT_EQ(out.end(), f1.get());
+    std::inclusive_scan(data.begin(), data.end(), expect.begin());
+    EXPECT_EQ(expect, out) << n;
+
+    auto [f2] = tp.exclusive_scan(data.begin(), data.end(), out.begin(), 5L, std::plus<>{},
+                                  thp::partition::EqualSize(data.begin(), data.end(), parts));
+    f2.get();
+    std::exclusive_scan(data.begin(), data.end(), expect.begin(), 5L);
+    EXPECT_EQ(expect, out) << n;
+
+    auto sq = [](long x) { return x * x; };
+    auto [f3] = tp.transform_inclusive_scan(data.begin(), data.end(), out.begin(), std::plus<>{}, sq,
+                                            thp::partition::EqualSize(data.begin(), data.end(), parts));
+    f3.get();
+    std::transform_inclusive_scan(data.begin(), data.end(), expect.begin(), std::plus<>{}, sq);
+    EXPECT_EQ(expect, out) << n;
+  }
+  tp.shutdown();
+}
+
+// associative but not commutative op, scanned in place
+TEST(ScanTest, in_place_keeps_order) {
+  thp::threadpool tp(3);
+  std::vector<std::string> data(500);
+  for (std::size_t i = 0; i < data.size(); ++i) data[i] = std::string(1, char('a' + i % 26));
+  std::vector<std::string> expect(data.size());
+  std::exclusive_scan(data.begin(), data.end(), expect.begin(), std::string(">"));
+
+  auto [f] = tp.exclusive_scan(data.begin(), data.end(), data.begin(), std::string(">"), std::plus<>{},
+                               thp::partition::EqualSize(data.begin(), data.end(), 9));
+  f.get();
+  EXPECT_EQ(expect, data);
+  tp.shutdown();
+}
+
+} // namespace
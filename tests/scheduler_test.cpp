@@ -0,0 +1,182 @@
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/scheduler.hpp"
+#include "include/algos/scheduling/auto_select.hpp"
+#include "include/threadpool.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+TEST(AdaptiveBatchTest, compute_stats) {
+  std::vector<thp::task_queue*> qs;
+  const std::vector<unsigned> weights;
+  thp::task_buffer out;
+  thp::statistics stats{std::chrono::system_clock::now(), {{qs, 100u, -1, weights}, {&out, 0}}, {4, 4}, {}};
+  thp::task_scheduler sched;
+
+  // no run time sample yet, move everything
+  sched.compute_stats(stats);
+  EXPECT_EQ(-1, stats.jobq.in.load_factor);
+  EXPECT_EQ(100u, stats.sched.batch);
+
+  // 1us tasks, 100us target per worker
+  stats.sched.exec_sample = 1us;
+  sched.compute_stats(stats);
+  EXPECT_EQ(thp::Static::max_load_factor(), stats.jobq.in.load_factor);
+  EXPECT_EQ(4u * thp::Static::max_load_factor(), stats.sched.batch);
+  EXPECT_EQ(thp::Static::scheduler_tick(), stats.sched.linger);
+
+  // long tasks, one per worker, linger capped
+  stats.sched.exec_time = {};
+  stats.sched.exec_sample = 1ms;
+  sched.compute_stats(stats);
+  EXPECT_EQ(1, stats.jobq.in.load_factor);
+  EXPECT_EQ(4u, stats.sched.batch);
+  EXPECT_EQ(thp::Static::max_sched_linger(), stats.sched.linger);
+
+  // idle workers with queued tasks: bigger batches, no lingering
+  stats.sched.exec_time = {};
+  stats.sched.exec_sample = 25us;
+  stats.sched.idle_workers = 2;
+  sched.compute_stats(stats);
+  EXPECT_EQ(8, stats.jobq.in.load_factor);
+  EXPECT_EQ(0ns, stats.sched.linger);
+
+  // tasks sit in output too long: scale comes down a step per tick
+  stats.sched.exec_sample = {};
+  stats.sched.idle_workers = 0;
+  stats.sched.wait_sample = 10ms;
+  stats.sched.wait_time = {};
+  for (int lf : {4, 2, 1, 1}) {
+    sched.compute_stats(stats);
+    EXPECT_EQ(lf, stats.jobq.in.load_factor);
+  }
+}
+
+// consecutive overloaded ticks keep doubling the batch up to the max, a
+// quiet tick keeps what was reached
+TEST(AdaptiveBatchTest, growth_is_cumulative) {
+  std::vector<thp::task_queue*> qs;
+  const std::vector<unsigned> weights;
+  thp::task_buffer out;
+  thp::statistics stats{std::chrono::system_clock::now(), {{qs, 100u, -1, weights}, {&out, 0}}, {4, 4}, {}};
+  thp::task_scheduler sched;
+
+  stats.sched.exec_sample = 25us;
+  stats.sched.idle_workers = 1;
+  for (int lf : {8, 16, 32, 64, 64}) {
+    sched.compute_stats(stats);
+    EXPECT_EQ(lf, stats.jobq.in.load_factor);
+    EXPECT_EQ(4u * lf, stats.sched.batch);
+  }
+
+  stats.sched.idle_workers = 0;
+  sched.compute_stats(stats);
+  EXPECT_EQ(64, stats.jobq.in.load_factor);
+
+  // one underloaded tick steps down from the max, not from the estimate
+  stats.sched.wait_sample = 10ms;
+  sched.compute_stats(stats);
+  EXPECT_EQ(32, stats.jobq.in.load_factor);
+}
+
+TEST(AdaptiveBatchTest, pool_publishes_decisions) {
+  thp::threadpool tp(2);
+  for (int round = 0; round < 20; ++round) {
+    std::vector<std::future<int>> fs;
+    for (int i = 0; i < 256; ++i) {
+      auto [f] = tp.schedule(thp::simple_task<int>([i] { return i; }));
+      fs.emplace_back(std::move(f));
+    }
+    for (int i = 0; i < 256; ++i) ASSERT_EQ(i, fs[i].get());
+  }
+  auto s = tp.scheduler_stats();
+  EXPECT_GT(s.exec_time.count(), 0);
+  EXPECT_GE(s.batch, 2u);
+  tp.shutdown();
+}
+
+// dispatches a fixed number of tasks per tick
+struct fixed_rate_algo : thp::sched_algos::schedule_algo {
+  explicit fixed_rate_algo(std::size_t n) : per_tick{n} {}
+  void apply(thp::statistics& stats) override { stats.jobq.out.new_tasks = per_tick; }
+  int apply(thp::statistics&, std::thread::id) override { return 0; }
+  std::size_t per_tick;
+};
+
+TEST(AutoSelectTest, converges_and_follows_shift) {
+  namespace sa = thp::sched_algos;
+  auto slow = std::make_shared<fixed_rate_algo>(1);
+  auto fast = std::make_shared<fixed_rate_algo>(8);
+  sa::auto_algo algo({{sa::eFairShare, slow}, {sa::eMaxLen, fast}});
+
+  std::vector<thp::task_queue*> qs;
+  const std::vector<unsigned> weights;
+  thp::task_buffer out;
+  thp::statistics stats{std::chrono::system_clock::time_point{}, {{qs, 0u, -1, weights}, {&out, 0}}, {4, 4}, {}};
+  auto run_for = [&](std::chrono::milliseconds d) {
+    for (auto end = stats.ts + d; stats.ts < end; stats.ts += 1ms) {
+      stats.jobq.out.reset();
+      algo.apply(stats);
+    }
+  };
+
+  run_for(2 * thp::Static::auto_trial_period() + 1ms);
+  EXPECT_TRUE(algo.converged());
+  EXPECT_EQ(sa::eMaxLen, algo.current());
+
+  // workload shifts, next exploration moves over
+  slow->per_tick = 64;
+  run_for(thp::Static::auto_exploit_period() + 4 * thp::Static::auto_trial_period());
+  EXPECT_TRUE(algo.converged());
+  EXPECT_EQ(sa::eFairShare, algo.current());
+}
+
+TEST(AutoSelectTest, switch_under_load) {
+  namespace sa = thp::sched_algos;
+  thp::threadpool tp(2);
+  EXPECT_EQ(sa::eFairShare, tp.algorithm());
+  const sa::names all[] = {sa::eFirstAvailable, sa::eMaxLen, sa::eEdf, sa::eAuto, sa::eFairShare};
+  for (auto n : all) {
+    std::vector<std::future<int>> fs;
+    for (int i = 0; i < 500; ++i) {
+      auto [f] = tp.schedule(thp::simple_task<int>([i] { return i; }));
+      fs.emplace_back(std::move(f));
+      if (i == 250) tp.set_algorithm(n);
+    }
+    for (int i = 0; i < 500; ++i) ASSERT_EQ(i, fs[i].get());
+    EXPECT_EQ(n, tp.algorithm());
+  }
+  EXPECT_THROW(tp.set_algorithm(sa::eInvalid), std::out_of_range);
+  tp.shutdown();
+}
+
+// workers take batches from priority queues themselves, with every algo
+TEST(DecentralizedTest, workers_schedule_themselves) {
+  namespace sa = thp::sched_algos;
+  thp::threadpool tp(thp::pool_config{.max_threads = 4, .dispatch = thp::dispatch_mode::eDecentralized});
+  tp.set_weight<int>(3);
+  const sa::names all[] = {sa::eFairShare, sa::eFirstAvailable, sa::eMaxLen, sa::eEdf, sa::eAuto};
+  for (auto n : all) {
+    tp.set_algorithm(n);
+    std::vector<std::future<int>> fs;
+    for (int i = 0; i < 300; ++i) {
+      thp::priority_task<int, int> t([i] { return i; });
+      t.set_priority(i % 5);
+      auto [f1] = tp.schedule(std::move(t));
+      auto [f2] = tp.schedule(thp::simple_task<int>([i] { return -i; }));
+      fs.emplace_back(std::move(f1));
+      fs.emplace_back(std::move(f2));
+    }
+    for (int i = 0; i < 300; ++i) {
+      ASSERT_EQ(i, fs[2*i].get());
+      ASSERT_EQ(-i, fs[2*i + 1].get());
+    }
+  }
+  tp.shutdown();
+}
+
+} // namespace
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/threadpool.hpp"
+
+namespace {
+
+TEST(SortTest, matches_std_sort) {
+  thp::threadpool tp(4);
+  std::mt19937 rng(7);
+  const std::size_t cut = thp::Static::stl_sort_cutoff();
+  for (std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(1000), cut + 1, 3 * cut + 17, 20 * cut + 5}) {
+    std::vector<int> data(n);
+    for (auto& x : data) x = static_cast<int>(rng() % 1000);
+    auto expect = data;
+    std::ranges::sort(expect);
+    auto [f] = tp.sort(data.begin(), data.end());
+    f.get();
+    ASSERT_EQ(expect, data) << n;
+  }
+  tp.shutdown();
+}
+
+TEST(SortTest, comparator_and_projection) {
+  thp::threadpool tp(3);
+  std::mt19937 rng(11);
+  std::vector<std::string> data(5 * thp::Static::stl_sort_cutoff() + 3);
+  for (auto& s : data) s = std::to_string(rng());
+  auto expect = data;
+  std::ranges::sort(expect, std::ranges::greater{}, &std::string::size);
+  auto [f] = tp.sort(data.begin(), data.end(), std::ranges::greater{}, &std::string::size);
+  f.get();
+  EXPECT_TRUE(std::ranges::is_sorted(data, std::ranges::greater{}, &std::string::size));
+  // same elements, none lost to moves between buffers
+  std::ranges::sort(expect);
+  std::ranges::sort(data);
+  EXPECT_EQ(expect, data);
+  tp.shutdown();
+}
+
+// sort from inside a task on a single worker pool
+TEST(SortTest, nested_on_one_worker) {
+  thp::threadpool tp(1);
+  std::vector<int> data(4 * thp::Static::stl_sort_cutoff());
+  for (std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<int>(data.size() - i);
+  auto [f] = tp.enqueue([&] {
+    auto [g] = tp.sort(data.begin(), data.end());
+    tp.get(g);
+  });
+  f.get();
+  EXPECT_TRUE(std::ranges::is_sorted(data));
+  tp.shutdown();
+}
+
+template <typename T>
+void check_radix(thp::threadpool& tp, std::size_t n, std::mt19937_64& rng) {
+  std::vector<T> data(n);
+  for (auto& x : data) {
+    if constexpr (std::is_floating_point_v<T>) x = static_cast<T>(std::normal_distribution<double>(0, 1e6)(rng));
+    else x = static_cast<T>(rng());
+  }
+  auto expect = data;
+  std::ranges::sort(expect);
+  auto [f] = tp.radix_sort(data.begin(), data.end());
+  f.get();
+  ASSERT_EQ(expect, data) << typeid(T).name() << " " << n;
+}
+
+TEST(SortTest, radix_key_types) {
+  thp::threadpool tp(4);
+  std::mt19937_64 rng(3);
+  for (std::size_t n : {std::size_t(0), std::size_t(100), std::size_t(10 * thp::Static::stl_sort_cutoff() + 9)}) {
+    check_radix<std::uint32_t>(tp, n, rng);
+    check_radix<std::uint64_t>(tp, n, rng);
+    check_radix<std::int16_t>(tp, n, rng);
+    check_radix<std::int64_t>(tp, n, rng);
+    check_radix<float>(tp, n, rng);
+    check_radix<double>(tp, n, rng);
+  }
+  tp.shutdown();
+}
+
+// sort by member through projection, equal keys keep their order
+TEST(SortTest, radix_projection_is_stable) {
+  struct kv { std::int32_t key; std::uint32_t seq; std::string payload; };
+  thp::threadpool tp(4);
+  std::mt19937 rng(5);
+  std::vector<kv> data(6 * thp::Static::stl_sort_cutoff());
+  for (std::uint32_t i = 0; i < data.size(); ++i) data[i] = {static_cast<std::int32_t>(rng() % 2000) - 1000, i, std::to_string(i)};
+  auto [f] = tp.radix_sort(data.begin(), data.end(), &kv::key);
+  f.get();
+  for (std::size_t i = 1; i < data.size(); ++i) {
+    ASSERT_LE(data[i - 1].key, data[i].key);
+    if (data[i - 1].key == data[i].key) {
+      ASSERT_LT(data[i - 1].seq, data[i].seq);
+    }
+  }
+  for (auto& x : data) ASSERT_EQ(std::to_string(x.seq), x.payload);
+  tp.shutdown();
+}
+
+// sort() picks radix sort for arithmetic keys with less or greater
+TEST(SortTest, dispatches_descending_to_radix) {
+  thp::threadpool tp(2);
+  std::mt19937_64 rng(9);
+  std::vector<double> data(3 * thp::Static::stl_sort_cutoff());
+  for (auto& x : data) x = std::uniform_real_distribution<double>(-1, 1)(rng);
+  auto [f] = tp.sort(data.begin(), data.end(), std::ranges::greater{});
+  f.get();
+  EXPECT_TRUE(std::ranges::is_sorted(data, std::ranges::greater{}));
+  tp.shutdown();
+}
+
+// keys without a radix mapping (long double) still sort, by merge sort
+TEST(SortTest, long_double_skips_radix) {
+  static_assert(!thp::sorting::radix_key<long double>);
+  thp::threadpool tp(2);
+  std::mt19937_64 rng(11);
+  std::vector<long double> data(3 * thp::Static::stl_sort_cutoff());
+  for (auto& x : data) x = std::normal_distribution<long double>(0, 1e6)(rng);
+  auto [f] = tp.sort(data.begin(), data.end());
+  f.get();
+  EXPECT_TRUE(std::ranges::is_sorted(data));
+  tp.shutdown();
+}
+
+} // namespace
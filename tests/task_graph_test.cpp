@@ -0,0 +1,76 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/threadpool.hpp"
+
+namespace {
+
+// every node sees all of its predecessors done, graph runs again as is
+TEST(TaskGraphTest, layered_graph_reruns) {
+  thp::threadpool tp(4);
+  constexpr int layers = 10, width = 20;
+  std::vector<std::atomic<int>> runs(layers * width);
+  std::atomic<int> violations{0};
+
+  thp::task_graph g;
+  for (int l = 0; l < layers; ++l) {
+    for (int w = 0; w < width; ++w) {
+      g.emplace([&, l, w] {
+        auto me = l * width + w;
+        if (l > 0)
+          for (int d : {w, (w + 1) % width})
+            if (runs[(l - 1) * width + d].load() != runs[me].load() + 1) ++violations;
+        ++runs[me];
+      });
+      if (l > 0) {
+        g.precede((l - 1) * width + w, l * width + w);
+        g.precede((l - 1) * width + (w + 1) % width, l * width + w);
+      }
+    }
+  }
+  ASSERT_EQ(std::size_t(layers * width), g.size());
+
+  for (int round = 1; round <= 20; ++round) {
+    tp.run(g).get();
+    EXPECT_FALSE(g.running());
+    for (auto& r : runs) ASSERT_EQ(round, r.load());
+  }
+  EXPECT_EQ(0, violations.load());
+  tp.shutdown();
+}
+
+// failed node skips its dependents, exception goes to run's future
+TEST(TaskGraphTest, exception_skips_dependents) {
+  thp::threadpool tp(2);
+  std::atomic<int> ran{0};
+  thp::task_graph g;
+  auto a = g.emplace([&] { ++ran; });
+  auto b = g.emplace([] { throw std::runtime_error("b"); });
+  auto c = g.emplace([&] { ++ran; });
+  g.precede(a, b);
+  g.precede(b, c);
+  EXPECT_THROW(tp.run(g).get(), std::runtime_error);
+  EXPECT_EQ(1, ran.load());
+  EXPECT_FALSE(g.running());
+  tp.shutdown();
+}
+
+TEST(TaskGraphTest, cycle_and_empty) {
+  thp::threadpool tp(2);
+  thp::task_graph empty;
+  EXPECT_NO_THROW(tp.run(empty).get());
+
+  thp::task_graph g;
+  auto a = g.emplace([] {});
+  auto b = g.emplace([] {});
+  g.precede(a, b);
+  g.precede(b, a);
+  EXPECT_THROW(tp.run(g), std::invalid_argument);
+  EXPECT_FALSE(g.running());
+  EXPECT_THROW(g.precede(a, 7), std::out_of_range);
+  tp.shutdown();
+}
+
+} // namespace
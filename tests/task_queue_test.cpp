@@ -0,0 +1,163 @@
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <random>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "include/task_type.hpp"
+#include "include/task_queue.hpp"
+#include "include/task_factory.hpp"
+#include "include/mpmc_taskq.hpp"
+#include "include/dary_heap.hpp"
+#include "include/bucket_taskq.hpp"
+#include "include/all_priority_types.hpp"
+
+namespace {
+
+int identity(int x) { return x; }
+
+TEST(MpmcTaskQueueTest, fifo) {
+  thp::mpmc_taskq q(4);
+  std::vector<std::future<int>> futs;
+  for (int i = 0; i < 10; ++i) {
+    auto t = thp::make_task(identity, i);
+    futs.emplace_back(t.future());
+    q.put(std::move(t));
+  }
+  // 4 in ring, rest spilled to overflow
+  EXPECT_EQ(4u, q.capacity());
+  EXPECT_EQ(10u, q.len());
+
+  thp::task_buffer out;
+  EXPECT_EQ(10u, q.pop_n(out, 100));
+  EXPECT_TRUE(q.empty());
+  for (; !out.empty(); out.pop_front()) out.front()();
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(i, futs[i].get());
+}
+
+// ring never empties under steady load, spilled tasks must still get out
+TEST(MpmcTaskQueueTest, overflow_not_starved) {
+  constexpr int spilled = 12, rounds = 1000;
+  thp::mpmc_taskq q(4);
+  std::vector<int> order;
+  int next = 0;
+  for (; next < spilled; ++next) q.put(thp::inplace_task([&order, i = next] { order.push_back(i); }));
+
+  for (int r = 0; r < rounds; ++r) {
+    thp::inplace_task t;
+    ASSERT_EQ(1u, q.pop(t));
+    t();
+    q.put(thp::inplace_task([&order, i = next++] { order.push_back(i); }));
+  }
+  for (thp::inplace_task t; q.pop(t) == 1u;) t();
+
+  ASSERT_EQ(static_cast<std::size_t>(next), order.size());
+  for (int i = 0; i < next; ++i) EXPECT_EQ(i, order[i]);
+}
+
+TEST(MpmcTaskQueueTest, concurrent_producers_consumers) {
+  constexpr int producers = 4, per_producer = 5000;
+  thp::mpmc_taskq q(1024);
+  std::atomic<int> sum{0}, popped{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&] {
+      for (int i = 0; i < per_producer; ++i)
+        q.put(thp::make_task([&sum] { sum.fetch_add(1); }));
+    });
+  for (int c = 0; c < 2; ++c)
+    threads.emplace_back([&] {
+      thp::inplace_task t;
+      while (popped.load() < producers*per_producer) {
+        if (q.pop(t)) {
+          t();
+          popped.fetch_add(1);
+        }
+      }
+    });
+  for (auto& th : threads) th.join();
+
+  EXPECT_EQ(producers*per_producer, sum.load());
+  EXPECT_EQ(0u, q.len());
+}
+
+TEST(DaryHeapTest, order) {
+  std::mt19937 rng(7);
+  std::vector<int> v(10000);
+  std::ranges::generate(v, [&] { return static_cast<int>(rng() % 1000); });
+
+  thp::dary_heap<int> h;
+  for (auto x : std::vector<int>(v.begin(), v.begin() + 100)) h.push(std::move(x));
+  h.push(v.begin() + 100, v.end()); // heapify path
+  EXPECT_EQ(v.size(), h.size());
+
+  std::ranges::sort(v, std::greater<>());
+  std::vector<int> out;
+  EXPECT_EQ(10u, h.pop_n(10, [&](int x) { out.push_back(x); }));
+  h.push(v.begin() + 5, v.begin() + 15); // sift up path
+  EXPECT_EQ(v.size(), h.pop_n(v.size() + 10, [&](int x) { out.push_back(x); }));
+  EXPECT_TRUE(h.empty());
+
+  v.insert(v.end(), v.begin() + 5, v.begin() + 15);
+  std::ranges::sort(v, std::greater<>());
+  EXPECT_TRUE(std::ranges::is_sorted(out.begin() + 10, out.end(), std::greater<>()));
+  EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0L), std::accumulate(out.begin(), out.end(), 0L));
+}
+
+TEST(PriorityTaskQueueTest, pop_n) {
+  thp::priority_taskq<int> q;
+  std::vector<int> ran;
+  for (int p : {3, 9, 1, 7, 5}) {
+    thp::priority_task<void, int> t([&ran, p] { ran.push_back(p); });
+    t.set_priority(int(p));
+    q.put(std::move(t));
+  }
+
+  thp::task_buffer out;
+  EXPECT_EQ(3u, q.pop_n(out, 3));
+  EXPECT_EQ(2u, q.len());
+  EXPECT_EQ(2u, q.pop_n(out, 10));
+  EXPECT_EQ(0u, q.pop_n(out, 10));
+  while (!out.empty()) {
+    out.front()();
+    out.pop_front();
+  }
+  EXPECT_EQ((std::vector<int>{9, 7, 5, 3, 1}), ran);
+}
+
+TEST(BucketTaskQueueTest, level_order_and_fifo) {
+  static_assert(std::is_same_v<thp::TaskQueueFor<thp::level>::type, thp::bucket_taskq<thp::level>>);
+  static_assert(std::is_same_v<thp::TaskQueueFor<uint8_t>::type, thp::bucket_taskq<uint8_t>>);
+  static_assert(std::is_same_v<thp::TaskQueueFor<int>::type, thp::priority_taskq<int>>);
+
+  using enum thp::level;
+  thp::bucket_taskq<thp::level> q;
+  std::vector<int> ran;
+  const std::pair<thp::level, int> items[] = {
+    {eLow, 1}, {eHighest, 2}, {eLow, 3}, {eNormal, 4}, {eHighest, 5}, {eLow, 6}
+  };
+  for (auto [p, id] : items) {
+    thp::priority_task<void, thp::level> t([&ran, id = id] { ran.push_back(id); });
+    t.set_priority(thp::level(p));
+    q.put(std::move(t));
+  }
+  EXPECT_EQ(6u, q.len());
+
+  thp::task_buffer out;
+  EXPECT_EQ(4u, q.pop_n(out, 4));
+  thp::inplace_task t;
+  EXPECT_EQ(1u, q.pop(t));
+  out.push_back(std::move(t));
+  EXPECT_EQ(1u, q.pop_n(out, 10));
+  EXPECT_EQ(0u, q.pop(t));
+  while (!out.empty()) {
+    out.front()();
+    out.pop_front();
+  }
+  EXPECT_EQ((std::vector<int>{2, 5, 4, 1, 3, 6}), ran);
+  EXPECT_EQ(63u, thp::bucket_taskq<thp::level>::level_of(thp::level(200)));
+}
+
+} // namespace
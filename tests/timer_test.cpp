@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "include/timer_wheel.hpp"
+#include "include/threadpool.hpp"
+#include "include/time_task.hpp"
+
+namespace {
+
+TEST(TimerWheelTest, fires_on_expiry) {
+  thp::timer_wheel w(1000);
+  std::mt19937_64 rng(3);
+  std::vector<std::uint64_t> fired_at(5000, 0), expiry(5000);
+  std::vector<thp::timer_id> ids;
+  std::uint64_t now = 1000;
+  for (std::size_t i = 0; i < expiry.size(); ++i) {
+    // spread over all levels
+    expiry[i] = now + 1 + (rng() % (std::uint64_t{1} << (8 * (1 + i % 4))));
+    ids.push_back(w.insert(expiry[i], [&fired_at, &now, i] { fired_at[i] = now; }));
+  }
+  for (std::size_t i = 0; i < ids.size(); i += 3) EXPECT_TRUE(w.cancel(ids[i]));
+  EXPECT_FALSE(w.cancel(ids[0]));
+  EXPECT_EQ(expiry.size() - (expiry.size() + 2) / 3, w.size());
+
+  thp::task_buffer due;
+  const auto last = *std::ranges::max_element(expiry);
+  while (!w.empty()) {
+    auto next = w.next_expiry();
+    ASSERT_TRUE(next.has_value());
+    now = std::min<std::uint64_t>(*next + rng() % 3, last);
+    w.advance(now, due);
+    for (; !due.empty(); due.pop_front()) due.front()();
+  }
+  for (std::size_t i = 0; i < expiry.size(); ++i) {
+    if (i % 3 == 0) EXPECT_EQ(0u, fired_at[i]);
+    else {
+      EXPECT_GE(fired_at[i], expiry[i]);   // never early
+      EXPECT_LE(fired_at[i], expiry[i] + 2);
+    }
+  }
+  EXPECT_FALSE(w.cancel(ids[1]));
+  EXPECT_FALSE(w.next_expiry().has_value());
+}
+
+TEST(TimerServiceTest, post_after_and_cancel) {
+  using namespace std::chrono;
+  thp::threadpool tp(1);
+  std::atomic<int> fired{0};
+  const auto start = steady_clock::now();
+  std::atomic<steady_clock::rep> at{0};
+  tp.post_after(milliseconds(20), [&] {
+    at = (steady_clock::now() - start).count();
+    fired++;
+  });
+  auto id = tp.post_after(milliseconds(30), [&] { fired += 100; });
+  EXPECT_TRUE(tp.cancel(id));
+
+  while (fired.load() == 0) std::this_thread::sleep_for(milliseconds(1));
+  std::this_thread::sleep_for(milliseconds(30));
+  EXPECT_EQ(1, fired.load());
+  EXPECT_GE(steady_clock::duration(at.load()), milliseconds(20));
+  tp.shutdown();
+}
+
+// delayed time task doesn't occupy the only worker
+TEST(TimerServiceTest, time_task_does_not_block_worker) {
+  using namespace std::chrono;
+  thp::threadpool tp(1);
+  thp::time_task<int, steady_clock> late([] { return 1; });
+  late.start_at(steady_clock::now() + milliseconds(200));
+  auto [f1] = tp.schedule(std::move(late));
+  auto [f2] = tp.enqueue([] { return 2; });
+
+  EXPECT_EQ(std::future_status::ready, f2.wait_for(milliseconds(100)));
+  EXPECT_EQ(std::future_status::timeout, f1.wait_for(milliseconds(0)));
+  EXPECT_EQ(1, f1.get());
+  tp.shutdown();
+}
+
+// series is run point by point, worker is free in between
+TEST(TimerServiceTest, time_series_task_does_not_block_worker) {
+  using namespace std::chrono;
+  thp::threadpool tp(1);
+  thp::time_series_task<3, int, steady_clock> series([] { return 3; });
+  series.after(milliseconds(10), milliseconds(20), milliseconds(30));
+  auto [fs] = tp.schedule(std::move(series));
+  auto [f] = tp.enqueue([] { return 2; });
+
+  EXPECT_EQ(std::future_status::ready, f.wait_for(milliseconds(100)));
+  auto results = fs.get();
+  for (std::size_t i = 0; i < 3; ++i) EXPECT_EQ(3, (*results)[i].get());
+  tp.shutdown();
+}
+
+TEST(PeriodicTest, fixed_rate_streams_results) {
+  using namespace std::chrono;
+  thp::threadpool tp(1);
+  std::atomic<int> n{0};
+  auto p = tp.schedule_every({.period = milliseconds(5), .runs = 5}, [&] { return ++n; });
+  // the only worker stays free between runs
+  auto [f] = tp.enqueue([] { return 7; });
+  EXPECT_EQ(std::future_status::ready, f.wait_for(milliseconds(100)));
+
+  auto results = p->results();
+  for (std::size_t i = 0; i < 5; ++i) EXPECT_EQ(static_cast<int>(i + 1), (*results)[i].get());
+  p->wait();
+  EXPECT_EQ(5u, p->runs());
+  tp.shutdown();
+}
+
+// slow run: ticks it overran are skipped, not run back to back
+TEST(PeriodicTest, coalesces_missed_ticks) {
+  using namespace std::chrono;
+  thp::threadpool tp(1);
+  std::atomic<int> n{0};
+  auto p = tp.schedule_every({.period = milliseconds(5), .runs = 3}, [&] {
+    if (n++ == 0) std::this_thread::sleep_for(milliseconds(23));
+  });
+  p->wait();
+  EXPECT_EQ(3, n.load());
+  EXPECT_GE(p->missed(), 3u);
+  tp.shutdown();
+}
+
+TEST(PeriodicTest, cancel_unbounded) {
+  using namespace std::chrono;
+  thp::threadpool tp(2);
+  std::atomic<int> n{0};
+  auto p = tp.schedule_every({.period = milliseconds(2), .mode = thp::period_mode::eFixedDelay}, [&] { ++n; });
+  while (n.load() < 3) std::this_thread::sleep_for(milliseconds(1));
+  p->cancel();
+  p->wait();
+  const auto seen = n.load();
+  std::this_thread::sleep_for(milliseconds(10));
+  EXPECT_EQ(seen, n.load());
+  EXPECT_TRUE(p->done());
+  tp.shutdown();
+}
+
+} // namespace